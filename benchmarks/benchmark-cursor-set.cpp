@@ -0,0 +1,84 @@
+// Copyright (C) 2023 Vincent Chambrin
+// This file is part of the 'libclang-utils' project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include "benchmark.h"
+
+#include "libclang-utils/clang-cursor.h"
+#include "libclang-utils/clang-index.h"
+#include "libclang-utils/clang-translation-unit.h"
+#include "libclang-utils/cursor-set.h"
+
+#include <unordered_set>
+#include <vector>
+
+/*
+ * Compares the sets of cursors: std::unordered_set<Cursor>, which calls
+ * clang_hashCursor() and clang_equalCursors(), the libclang CXCursorSet
+ * and FlatCursorSet.
+ * Every cursor of the AST is inserted twice, then looked up, like in a
+ * graph walk with a visited set.
+ *
+ * Usage: BENCHMARK_cursor_set [file.cpp]
+ */
+
+int main(int argc, char* argv[])
+{
+  std::string path = "benchmark-cursor-set-input.cpp";
+
+  if (argc > 1)
+    path = argv[1];
+  else
+    benchmark::writeSourceFile(path, 2000);
+
+  libclang::LibClang libclang;
+  libclang::Index index = libclang.createIndex();
+  libclang::TranslationUnit tu = index.parseTranslationUnit(path, {});
+
+  std::vector<CXCursor> cursors;
+  tu.getCursor().visitRecursively([&cursors](const libclang::Cursor& c, const libclang::Cursor&) {
+    cursors.push_back(c);
+    return libclang::VisitResult::Recurse;
+    });
+
+  benchmark::run("std::unordered_set<Cursor>", 5, [&]() {
+    std::unordered_set<libclang::Cursor> set;
+    size_t n = 0;
+    for (int pass(0); pass < 2; ++pass)
+    {
+      for (const CXCursor& c : cursors)
+        n += set.insert(libclang::Cursor(libclang, c)).second ? 1 : 0;
+    }
+    for (const CXCursor& c : cursors)
+      n += set.count(libclang::Cursor(libclang, c));
+    return n;
+    });
+
+  benchmark::run("CursorSet", 5, [&]() {
+    libclang::CursorSet set{ libclang };
+    size_t n = 0;
+    for (int pass(0); pass < 2; ++pass)
+    {
+      for (const CXCursor& c : cursors)
+        n += set.insert(c) ? 1 : 0;
+    }
+    for (const CXCursor& c : cursors)
+      n += set.contains(c) ? 1 : 0;
+    return n;
+    });
+
+  benchmark::run("FlatCursorSet", 5, [&]() {
+    libclang::FlatCursorSet set;
+    size_t n = 0;
+    for (int pass(0); pass < 2; ++pass)
+    {
+      for (const CXCursor& c : cursors)
+        n += set.insert(c) ? 1 : 0;
+    }
+    for (const CXCursor& c : cursors)
+      n += set.contains(c) ? 1 : 0;
+    return n;
+    });
+
+  return 0;
+}
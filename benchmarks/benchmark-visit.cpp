@@ -0,0 +1,91 @@
+// Copyright (C) 2023 Vincent Chambrin
+// This file is part of the 'libclang-utils' project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include "benchmark.h"
+
+#include "libclang-utils/clang-cursor.h"
+#include "libclang-utils/clang-index.h"
+#include "libclang-utils/clang-translation-unit.h"
+#include "libclang-utils/visit-descendants.h"
+
+#include <functional>
+
+/*
+ * Compares walking the whole AST with nested calls to visitChildren()
+ * (one libclang traversal per node) and with a single call to
+ * visitRecursively().
+ * Also compares filtering function declarations in the functor and with
+ * visitDescendants().
+ *
+ * Usage: BENCHMARK_visit [file.cpp]
+ */
+
+static size_t count_nested(const libclang::Cursor& c)
+{
+  size_t n = 0;
+
+  c.visitChildren([&n](const libclang::Cursor& child) {
+    n += 1 + count_nested(child);
+    });
+
+  return n;
+}
+
+int main(int argc, char* argv[])
+{
+  std::string path = "benchmark-visit-input.cpp";
+
+  if (argc > 1)
+    path = argv[1];
+  else
+    benchmark::writeSourceFile(path, 2000);
+
+  libclang::LibClang libclang;
+  libclang::Index index = libclang.createIndex();
+  libclang::TranslationUnit tu = index.parseTranslationUnit(path, {});
+  libclang::Cursor root = tu.getCursor();
+
+  benchmark::run("nested visitChildren", 5, [&root]() {
+    return count_nested(root);
+    });
+
+  benchmark::run("visitRecursively", 5, [&root]() {
+    size_t n = 0;
+    root.visitRecursively([&n](const libclang::Cursor&, const libclang::Cursor&) {
+      ++n;
+      return libclang::VisitResult::Recurse;
+      });
+    return n;
+    });
+
+  benchmark::run("functions, visitRecursively", 5, [&root]() {
+    size_t n = 0;
+    root.visitRecursively([&n](const libclang::Cursor& c, const libclang::Cursor&) {
+      if (c.kind() == CXCursor_FunctionDecl)
+        ++n;
+      return libclang::VisitResult::Recurse;
+      });
+    return n;
+    });
+
+  benchmark::run("functions, visitDescendants", 5, [&root]() {
+    size_t n = 0;
+    libclang::visitDescendants<CXCursor_FunctionDecl>(root, [&n](const libclang::Cursor&) {
+      ++n;
+      });
+    return n;
+    });
+
+  benchmark::run("functions, visitDescendants skipping bodies", 5, [&root]() {
+    size_t n = 0;
+    libclang::VisitDescendantsOptions opts;
+    opts.skipFunctionBodies = true;
+    libclang::visitDescendants<CXCursor_FunctionDecl>(root, [&n](const libclang::Cursor&) {
+      ++n;
+      }, opts);
+    return n;
+    });
+
+  return 0;
+}
@@ -0,0 +1,57 @@
+// Copyright (C) 2023 Vincent Chambrin
+// This file is part of the 'libclang-utils' project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#ifndef LIBCLANGUTILS_BENCHMARK_H
+#define LIBCLANGUTILS_BENCHMARK_H
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+namespace benchmark
+{
+
+/**
+ * \brief runs a function several times and prints the best time
+ */
+template<typename F>
+void run(const std::string& name, int repetitions, F&& f)
+{
+  double best = 1e30;
+  size_t result = 0;
+
+  for (int i(0); i < repetitions; ++i)
+  {
+    auto start = std::chrono::steady_clock::now();
+    result = f();
+    auto end = std::chrono::steady_clock::now();
+    best = std::min(best, std::chrono::duration<double, std::milli>(end - start).count());
+  }
+
+  std::cout << name << ": " << best << " ms (result = " << result << ")" << std::endl;
+}
+
+/**
+ * \brief writes a C++ file with many functions and classes
+ */
+inline void writeSourceFile(const std::string& path, int count)
+{
+  std::ofstream file{ path };
+
+  for (int i(0); i < count; ++i)
+  {
+    file << "struct S" << i << " { int a; int b; int get() const { return a + b; } };\n";
+    file << "int f" << i << "(S" << i << " s, int n) {\n"
+      << "  int r = 0;\n"
+      << "  for (int j = 0; j < n; ++j) { if (j % 2 == 0) r += s.get() * j; else r -= s.a; }\n"
+      << "  return r;\n"
+      << "}\n";
+  }
+}
+
+} // namespace benchmark
+
+#endif // LIBCLANGUTILS_BENCHMARK_H
@@ -0,0 +1,63 @@
+// Copyright (C) 2023 Vincent Chambrin
+// This file is part of the 'libclang-utils' project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#ifndef LIBCLANGUTILS_ARRAYVIEW_H
+#define LIBCLANGUTILS_ARRAYVIEW_H
+
+#include <cstddef>
+#include <vector>
+
+namespace libclang
+{
+
+/**
+ * \brief a non-owning view over a contiguous sequence of elements
+ *
+ * This is a minimal replacement for std::span, which is not available in
+ * C++14.
+ */
+template<typename T>
+class ArrayView
+{
+private:
+  const T* m_data = nullptr;
+  size_t m_size = 0;
+
+public:
+  ArrayView() = default;
+  ArrayView(const ArrayView&) = default;
+  ~ArrayView() = default;
+
+  ArrayView(const T* data, size_t size)
+    : m_data(data), m_size(size)
+  {
+
+  }
+
+  ArrayView(const std::vector<T>& vec)
+    : m_data(vec.data()), m_size(vec.size())
+  {
+
+  }
+
+  const T* data() const { return m_data; }
+  size_t size() const { return m_size; }
+  bool empty() const { return m_size == 0; }
+
+  const T* begin() const { return m_data; }
+  const T* end() const { return m_data + m_size; }
+
+  const T& front() const { return m_data[0]; }
+  const T& back() const { return m_data[m_size - 1]; }
+
+  const T& operator[](size_t i) const { return m_data[i]; }
+
+  std::vector<T> toVector() const { return std::vector<T>(begin(), end()); }
+
+  ArrayView& operator=(const ArrayView&) = default;
+};
+
+} // namespace libclang
+
+#endif // LIBCLANGUTILS_ARRAYVIEW_H
@@ -0,0 +1,218 @@
+// Copyright (C) 2023 Vincent Chambrin
+// This file is part of the 'libclang-utils' project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#ifndef LIBCLANGUTILS_ASTSNAPSHOT_H
+#define LIBCLANGUTILS_ASTSNAPSHOT_H
+
+#include "libclang-utils/clang-cursor.h"
+#include "libclang-utils/file-table.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace libclang
+{
+
+class TranslationUnit;
+
+/**
+ * \brief a flattened copy of the cursor tree of a translation unit
+ *
+ * The snapshot is built with a single recursive traversal of the AST
+ * and stores the properties of each node in parallel arrays (one
+ * element per node), nodes being numbered in pre-order.
+ * The root has id 0 and the descendants of a node \a n are the nodes
+ * in the range [n + 1, subtree_ends[n]).
+ *
+ * Navigating the tree (parent, children, siblings) is O(1) and never
+ * calls libclang; the original cursor of a node is still available
+ * with cursor().
+ *
+ * The snapshot must not outlive the translation unit it was built from.
+ */
+class LIBCLANGU_API AstSnapshot
+{
+public:
+  typedef uint32_t NodeId;
+  static const NodeId NoNode = 0xFFFFFFFF;
+
+public:
+  LibClang* api = nullptr;
+
+  std::vector<CXCursorKind> kinds;
+  std::vector<NodeId> parents;
+  std::vector<NodeId> first_children;
+  std::vector<NodeId> next_siblings;
+  std::vector<NodeId> subtree_ends;
+  std::vector<unsigned> begin_offsets;
+  std::vector<unsigned> end_offsets;
+  std::vector<FileTable::Id> file_ids;
+  std::vector<CXCursor> cursors;
+
+  // children of node n are children[child_offsets[n] .. child_offsets[n + 1])
+  std::vector<uint32_t> child_offsets;
+  std::vector<NodeId> children;
+  std::vector<uint32_t> child_indices;
+
+  FileTable file_table;
+
+public:
+  AstSnapshot() = default;
+  AstSnapshot(const AstSnapshot&) = delete;
+  AstSnapshot(AstSnapshot&&) = default;
+  ~AstSnapshot() = default;
+
+  explicit AstSnapshot(const TranslationUnit& tu);
+  AstSnapshot(const TranslationUnit& tu, const Cursor& root);
+
+  bool empty() const;
+  size_t size() const;
+
+  NodeId root() const;
+
+  CXCursorKind kind(NodeId n) const;
+  NodeId parent(NodeId n) const;
+  NodeId firstChild(NodeId n) const;
+  NodeId nextSibling(NodeId n) const;
+  NodeId subtreeEnd(NodeId n) const;
+
+  size_t childCount(NodeId n) const;
+  NodeId childAt(NodeId n, size_t index) const;
+  int indexOfChild(NodeId n, NodeId child) const;
+
+  unsigned beginOffset(NodeId n) const;
+  unsigned endOffset(NodeId n) const;
+  FileTable::Id file(NodeId n) const;
+
+  Cursor cursor(NodeId n) const;
+
+  AstSnapshot& operator=(const AstSnapshot&) = delete;
+  AstSnapshot& operator=(AstSnapshot&&) = default;
+};
+
+/**
+ * \brief returns whether the snapshot has no node
+ */
+inline bool AstSnapshot::empty() const
+{
+  return kinds.empty();
+}
+
+/**
+ * \brief returns the number of nodes in the snapshot
+ */
+inline size_t AstSnapshot::size() const
+{
+  return kinds.size();
+}
+
+/**
+ * \brief returns the id of the root node
+ */
+inline AstSnapshot::NodeId AstSnapshot::root() const
+{
+  return empty() ? NoNode : 0;
+}
+
+/**
+ * \brief returns the cursor kind of a node
+ */
+inline CXCursorKind AstSnapshot::kind(NodeId n) const
+{
+  return kinds[n];
+}
+
+/**
+ * \brief returns the parent of a node, or NoNode for the root
+ */
+inline AstSnapshot::NodeId AstSnapshot::parent(NodeId n) const
+{
+  return parents[n];
+}
+
+/**
+ * \brief returns the first child of a node, or NoNode
+ */
+inline AstSnapshot::NodeId AstSnapshot::firstChild(NodeId n) const
+{
+  return first_children[n];
+}
+
+/**
+ * \brief returns the next sibling of a node, or NoNode
+ */
+inline AstSnapshot::NodeId AstSnapshot::nextSibling(NodeId n) const
+{
+  return next_siblings[n];
+}
+
+/**
+ * \brief returns the id following the last descendant of a node
+ */
+inline AstSnapshot::NodeId AstSnapshot::subtreeEnd(NodeId n) const
+{
+  return subtree_ends[n];
+}
+
+/**
+ * \brief returns the number of children of a node
+ */
+inline size_t AstSnapshot::childCount(NodeId n) const
+{
+  return child_offsets[n + 1] - child_offsets[n];
+}
+
+/**
+ * \brief returns the child of a node at the given index
+ */
+inline AstSnapshot::NodeId AstSnapshot::childAt(NodeId n, size_t index) const
+{
+  return children[child_offsets[n] + index];
+}
+
+/**
+ * \brief returns the index of a child
+ * \return the index or -1 if \a child isn't a direct child of \a n
+ */
+inline int AstSnapshot::indexOfChild(NodeId n, NodeId child) const
+{
+  return parents[child] == n ? static_cast<int>(child_indices[child]) : -1;
+}
+
+/**
+ * \brief returns the offset of the start of the extent of a node
+ */
+inline unsigned AstSnapshot::beginOffset(NodeId n) const
+{
+  return begin_offsets[n];
+}
+
+/**
+ * \brief returns the offset of the end of the extent of a node
+ */
+inline unsigned AstSnapshot::endOffset(NodeId n) const
+{
+  return end_offsets[n];
+}
+
+/**
+ * \brief returns the id in the file table of the file of a node
+ * \return the file id, or FileTable::NoFile
+ */
+inline FileTable::Id AstSnapshot::file(NodeId n) const
+{
+  return file_ids[n];
+}
+
+/**
+ * \brief returns the cursor a node was built from
+ */
+inline Cursor AstSnapshot::cursor(NodeId n) const
+{
+  return Cursor(*api, cursors[n]);
+}
+
+} // namespace libclang
+
+#endif // LIBCLANGUTILS_ASTSNAPSHOT_H
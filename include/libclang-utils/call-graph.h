@@ -0,0 +1,166 @@
+// Copyright (C) 2023 Vincent Chambrin
+// This file is part of the 'libclang-utils' project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#ifndef LIBCLANGUTILS_CALLGRAPH_H
+#define LIBCLANGUTILS_CALLGRAPH_H
+
+#include "libclang-utils/array-view.h"
+#include "libclang-utils/symbol-key.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace libclang
+{
+
+class ThreadPool;
+class TranslationUnit;
+
+/**
+ * \brief a call from a function to another
+ */
+struct CallEdge
+{
+  enum Flag
+  {
+    DirectCall = 0,
+    DynamicCall = 0x01,    // virtual call, see clang_Cursor_isDynamicCall()
+    OverloadedCall = 0x02, // unresolved call to one of an overload set
+  };
+
+  SymbolKey caller;
+  SymbolKey callee;
+  uint8_t flags;
+};
+
+/**
+ * \brief a call graph in compressed sparse row form
+ *
+ * Functions are identified by the SymbolKey of their USR and numbered
+ * with dense ids in the order of their keys.
+ * The callees of node n are callees[callee_offsets[n] .. callee_offsets[n + 1])
+ * and the callers are stored the same way, so traversals in both
+ * directions only read contiguous arrays of integers.
+ *
+ * Calls are attributed to the function definition that contains them,
+ * including calls made from the lambdas and local classes of the function.
+ * An edge is stored once per (caller, callee) pair, whatever the number of
+ * call sites; its flags are the union of the flags of its call sites.
+ */
+class LIBCLANGU_API CallGraph
+{
+public:
+  typedef uint32_t NodeId;
+  static const NodeId NoNode = 0xFFFFFFFF;
+
+private:
+  std::vector<CallEdge> m_edges;
+  std::vector<SymbolKey> m_nodes;
+  std::vector<uint32_t> m_callee_offsets;
+  std::vector<NodeId> m_callees;
+  std::vector<uint8_t> m_flags;
+  std::vector<uint32_t> m_caller_offsets;
+  std::vector<NodeId> m_callers;
+
+public:
+  CallGraph();
+  CallGraph(const CallGraph&) = default;
+  CallGraph(CallGraph&&) = default;
+  ~CallGraph() = default;
+
+  explicit CallGraph(const TranslationUnit& tu);
+  explicit CallGraph(std::vector<CallEdge> edges);
+
+  size_t nodeCount() const;
+  size_t edgeCount() const;
+  const std::vector<CallEdge>& edges() const;
+
+  NodeId find(SymbolKey function) const;
+  SymbolKey key(NodeId n) const;
+
+  ArrayView<NodeId> callees(NodeId n) const;
+  ArrayView<uint8_t> calleeFlags(NodeId n) const;
+  ArrayView<NodeId> callers(NodeId n) const;
+
+  std::vector<NodeId> reachableFrom(NodeId n) const;
+  std::vector<NodeId> impactOf(NodeId n) const;
+
+  void merge(const CallGraph& other);
+
+  CallGraph& operator=(const CallGraph&) = default;
+  CallGraph& operator=(CallGraph&&) = default;
+
+protected:
+  void build();
+};
+
+LIBCLANGU_API CallGraph buildCallGraph(ThreadPool& pool, const std::vector<const TranslationUnit*>& units);
+
+/**
+ * \brief returns the number of functions in the graph
+ */
+inline size_t CallGraph::nodeCount() const
+{
+  return m_nodes.size();
+}
+
+/**
+ * \brief returns the number of edges in the graph
+ */
+inline size_t CallGraph::edgeCount() const
+{
+  return m_edges.size();
+}
+
+/**
+ * \brief returns the edges sorted by caller then callee
+ */
+inline const std::vector<CallEdge>& CallGraph::edges() const
+{
+  return m_edges;
+}
+
+/**
+ * \brief returns the key of a node
+ */
+inline SymbolKey CallGraph::key(NodeId n) const
+{
+  return m_nodes[n];
+}
+
+/**
+ * \brief returns the functions called by a function
+ */
+inline ArrayView<CallGraph::NodeId> CallGraph::callees(NodeId n) const
+{
+  return ArrayView<NodeId>(m_callees.data() + m_callee_offsets[n], m_callee_offsets[n + 1] - m_callee_offsets[n]);
+}
+
+/**
+ * \brief returns the flags of the edges to the callees of a function
+ *
+ * The i-th element is the combination of CallEdge::Flag of the i-th callee.
+ */
+inline ArrayView<uint8_t> CallGraph::calleeFlags(NodeId n) const
+{
+  return ArrayView<uint8_t>(m_flags.data() + m_callee_offsets[n], m_callee_offsets[n + 1] - m_callee_offsets[n]);
+}
+
+/**
+ * \brief returns the functions calling a function
+ */
+inline ArrayView<CallGraph::NodeId> CallGraph::callers(NodeId n) const
+{
+  return ArrayView<NodeId>(m_callers.data() + m_caller_offsets[n], m_caller_offsets[n + 1] - m_caller_offsets[n]);
+}
+
+namespace details
+{
+LIBCLANGU_API void sort_call_edges(std::vector<CallEdge>& edges);
+LIBCLANGU_API std::vector<CallEdge> merge_call_edges(const std::vector<CallEdge>& a, const std::vector<CallEdge>& b);
+} // namespace details
+
+} // namespace libclang
+
+#endif // LIBCLANGUTILS_CALLGRAPH_H
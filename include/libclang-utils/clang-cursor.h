@@ -7,6 +7,7 @@
 
 #include "libclang-utils/libclang.h"
 #include "libclang-utils/clang-source-location.h"
+#include "libclang-utils/clang-string.h"
 #include "libclang-utils/clang-source-range.h"
 #include "libclang-utils/clang-type.h"
 
@@ -22,6 +23,7 @@ namespace libclang
 {
 
 class File;
+class PrintingPolicy;
 
 /*!
  * \class Cursor
@@ -74,6 +76,7 @@ public:
   std::string getUSR() const;
   std::string getMangling() const;
   std::string getDisplayName() const;
+  ClangString prettyPrinted(const PrintingPolicy& policy) const;
 
   Cursor getLexicalParent() const;
   Cursor getSemanticParent() const;
@@ -87,6 +90,9 @@ public:
 
   Type getType() const;
   Type getTypedefDeclUnderlyingType() const;
+  Type getEnumDeclIntegerType() const;
+  long long getEnumConstantDeclValue() const;
+  unsigned long long getEnumConstantDeclUnsignedValue() const;
 
   int getNumArguments() const;
   Cursor getArgument(int index) const;
@@ -98,6 +104,10 @@ public:
   SourceLocation getLocation() const;
   SourceRange getExtent() const;
 
+  std::string getRawCommentText() const;
+  std::string getBriefCommentText() const;
+  SourceRange getCommentRange() const;
+
   bool isConstructor() const;
   bool isDestructor() const;
 
@@ -108,6 +118,17 @@ public:
   bool CXXMethod_isStatic() const;
   bool CXXMethod_isVirtual() const;
   bool CXXMethod_isPureVirtual() const;
+  std::vector<Cursor> getOverriddenCursors() const;
+
+  bool isVirtualBase() const;
+
+  Cursor getSpecializedCursorTemplate() const;
+  CXCursorKind getTemplateCursorKind() const;
+  int getNumTemplateArguments() const;
+  CXTemplateArgumentKind getTemplateArgumentKind(unsigned index) const;
+  Type getTemplateArgumentType(unsigned index) const;
+  long long getTemplateArgumentValue(unsigned index) const;
+  unsigned long long getTemplateArgumentUnsignedValue(unsigned index) const;
 
   size_t childCount() const;
   Cursor childAt(size_t index) const;
@@ -117,6 +138,9 @@ public:
   template<typename Func>
   void visitChildren(Func&& f) const;
 
+  template<typename Func>
+  bool visitRecursively(Func&& f) const;
+
   operator CXCursor() const;
 };
 
@@ -324,6 +348,30 @@ inline Type Cursor::getTypedefDeclUnderlyingType() const
   return Type(*api, api->clang_getTypedefDeclUnderlyingType(*this));
 }
 
+/**
+ * \brief returns the integer type of an enum declaration
+ */
+inline Type Cursor::getEnumDeclIntegerType() const
+{
+  return Type(*api, api->clang_getEnumDeclIntegerType(this->cursor));
+}
+
+/**
+ * \brief returns the value of an enum constant declaration
+ */
+inline long long Cursor::getEnumConstantDeclValue() const
+{
+  return api->clang_getEnumConstantDeclValue(this->cursor);
+}
+
+/**
+ * \brief returns the value of an enum constant declaration as an unsigned integer
+ */
+inline unsigned long long Cursor::getEnumConstantDeclUnsignedValue() const
+{
+  return api->clang_getEnumConstantDeclUnsignedValue(this->cursor);
+}
+
 /*!
  * \fn int getNumArguments() const
  */
@@ -374,6 +422,32 @@ inline SourceRange Cursor::getExtent() const
   return SourceRange(*api, api->clang_getCursorExtent(*this));
 }
 
+/**
+ * \brief returns the text of the documentation comment attached to this declaration
+ *
+ * Returns an empty string if the declaration has no comment.
+ */
+inline std::string Cursor::getRawCommentText() const
+{
+  return api->toStdString(api->clang_Cursor_getRawCommentText(this->cursor));
+}
+
+/**
+ * \brief returns the first paragraph of the documentation comment attached to this declaration
+ */
+inline std::string Cursor::getBriefCommentText() const
+{
+  return api->toStdString(api->clang_Cursor_getBriefCommentText(this->cursor));
+}
+
+/**
+ * \brief returns the source range of the documentation comment attached to this declaration
+ */
+inline SourceRange Cursor::getCommentRange() const
+{
+  return SourceRange(*api, api->clang_Cursor_getCommentRange(this->cursor));
+}
+
 /*!
  * \fn bool isConstructor() const
  * \brief convenience function that returns whether this cursor is a constructor
@@ -450,6 +524,89 @@ inline bool Cursor::CXXMethod_isPureVirtual() const
   return api->clang_CXXMethod_isPureVirtual(*this);
 }
 
+/**
+ * \brief returns whether the cursor is a virtual base specifier
+ */
+inline bool Cursor::isVirtualBase() const
+{
+  return api->clang_isVirtualBase(*this);
+}
+
+/**
+ * \brief returns the template this cursor is a specialization or an instantiation of
+ *
+ * Returns a null cursor if this cursor is not a specialization.
+ */
+inline Cursor Cursor::getSpecializedCursorTemplate() const
+{
+  return Cursor(*api, api->clang_getSpecializedCursorTemplate(this->cursor));
+}
+
+/**
+ * \brief returns the kind of the declarations the template would produce
+ *
+ * Returns CXCursor_NoDeclFound if this cursor is not a template.
+ */
+inline CXCursorKind Cursor::getTemplateCursorKind() const
+{
+  return api->clang_getTemplateCursorKind(this->cursor);
+}
+
+/**
+ * \brief returns the number of template arguments of a specialization
+ *
+ * Returns -1 if the cursor is neither a function nor a class template specialization.
+ */
+inline int Cursor::getNumTemplateArguments() const
+{
+  return api->clang_Cursor_getNumTemplateArguments(this->cursor);
+}
+
+/**
+ * \brief returns the kind of a template argument
+ */
+inline CXTemplateArgumentKind Cursor::getTemplateArgumentKind(unsigned index) const
+{
+  return api->clang_Cursor_getTemplateArgumentKind(this->cursor, index);
+}
+
+/**
+ * \brief returns the type of a type template argument
+ */
+inline Type Cursor::getTemplateArgumentType(unsigned index) const
+{
+  return Type(*api, api->clang_Cursor_getTemplateArgumentType(this->cursor, index));
+}
+
+/**
+ * \brief returns the value of an integral template argument
+ */
+inline long long Cursor::getTemplateArgumentValue(unsigned index) const
+{
+  return api->clang_Cursor_getTemplateArgumentValue(this->cursor, index);
+}
+
+/**
+ * \brief returns the value of an unsigned integral template argument
+ */
+inline unsigned long long Cursor::getTemplateArgumentUnsignedValue(unsigned index) const
+{
+  return api->clang_Cursor_getTemplateArgumentUnsignedValue(this->cursor, index);
+}
+
+/**
+ * \brief the value returned by the functor of Cursor::visitRecursively()
+ *
+ * SkipSubtree moves on to the next sibling without visiting the children
+ * of the current cursor.
+ */
+enum class VisitResult
+{
+  Break = CXChildVisit_Break,
+  SkipSubtree = CXChildVisit_Continue,
+  Recurse = CXChildVisit_Recurse,
+};
+
 namespace details
 {
 
@@ -484,6 +641,14 @@ CXChildVisitResult generic_visit_callback(CXCursor c, CXCursor p, CXClientData c
   return data.should_break ? CXChildVisit_Break : CXChildVisit_Continue;
 }
 
+template<typename T>
+CXChildVisitResult recursive_visit_callback(CXCursor c, CXCursor p, CXClientData client_data)
+{
+  VisitorData<T>& data = *static_cast<VisitorData<T>*>(client_data);
+  VisitResult result = data.functor(Cursor{ data.libclang, c }, Cursor{ data.libclang, p });
+  return static_cast<CXChildVisitResult>(result);
+}
+
 } // namespace details
 
 /*!
@@ -496,6 +661,25 @@ inline void Cursor::visitChildren(Func&& f) const
   api->clang_visitChildren(this->cursor, details::generic_visit_callback<Func>, &data);
 }
 
+/**
+ * \brief visits the descendants of this cursor
+ * \param f  a functor called as f(const Cursor& c, const Cursor& parent)
+ * \return true if the traversal was stopped by returning VisitResult::Break
+ *
+ * The functor returns a VisitResult telling whether the children of \a c
+ * should be visited (Recurse), skipped (SkipSubtree), or whether
+ * the traversal should stop (Break).
+ *
+ * Unlike nesting calls to visitChildren(), the whole tree is walked by a
+ * single call to clang_visitChildren().
+ */
+template<typename Func>
+inline bool Cursor::visitRecursively(Func&& f) const
+{
+  details::VisitorData<Func> data{ *api, f, false };
+  return api->clang_visitChildren(this->cursor, details::recursive_visit_callback<Func>, &data) != 0;
+}
+
 /*!
  * \fn operator CXCursor() const
  */
@@ -0,0 +1,175 @@
+// Copyright (C) 2023 Vincent Chambrin
+// This file is part of the 'libclang-utils' project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#ifndef LIBCLANGUTILS_CLANG_DIAGNOSTIC_H
+#define LIBCLANGUTILS_CLANG_DIAGNOSTIC_H
+
+#include "libclang-utils/libclang.h"
+#include "libclang-utils/string-table.h"
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace libclang
+{
+
+class TranslationUnit;
+
+/**
+ * \brief a compact description of a diagnostic
+ *
+ * Strings are stored as ids in the StringTable of the DiagnosticList
+ * the record belongs to.
+ */
+struct DiagnosticRecord
+{
+  static const uint32_t NoParent = 0xFFFFFFFF;
+
+  CXDiagnosticSeverity severity;
+  unsigned category;
+  StringTable::Id file;
+  unsigned line;
+  unsigned column;
+  unsigned offset;
+  StringTable::Id message;
+  StringTable::Id option;
+  uint32_t parent; // index of the parent diagnostic for notes, NoParent otherwise
+  uint32_t occurrences; // number of times the diagnostic was reported
+};
+
+namespace details
+{
+
+struct DiagnosticKey
+{
+  uint32_t values[8];
+};
+
+inline bool operator==(const DiagnosticKey& lhs, const DiagnosticKey& rhs)
+{
+  for (size_t i(0); i < 8; ++i)
+  {
+    if (lhs.values[i] != rhs.values[i])
+      return false;
+  }
+
+  return true;
+}
+
+struct DiagnosticKeyHash
+{
+  std::size_t operator()(const DiagnosticKey& key) const noexcept
+  {
+    std::size_t h = 0;
+
+    for (uint32_t v : key.values)
+      h = h * 31 + v;
+
+    return h;
+  }
+};
+
+} // namespace details
+
+/**
+ * \brief a deduplicated list of diagnostics
+ *
+ * Adding a diagnostic that is identical to one already in the list (same
+ * severity, location, message, option and parent) only increments the
+ * occurrence count of the existing record.
+ * This typically happens for diagnostics coming from headers shared by
+ * several translation units.
+ */
+class LIBCLANGU_API DiagnosticList
+{
+public:
+  StringTable strings;
+  std::vector<DiagnosticRecord> records;
+
+private:
+  std::unordered_map<details::DiagnosticKey, uint32_t, details::DiagnosticKeyHash> m_index;
+
+public:
+  DiagnosticList() = default;
+  DiagnosticList(const DiagnosticList&) = delete;
+  DiagnosticList(DiagnosticList&&) = default;
+  ~DiagnosticList() = default;
+
+  bool empty() const;
+  size_t size() const;
+  const DiagnosticRecord& at(size_t i) const;
+
+  StringView fileName(const DiagnosticRecord& d) const;
+  StringView message(const DiagnosticRecord& d) const;
+  StringView option(const DiagnosticRecord& d) const;
+
+  uint32_t add(LibClang& api, CXDiagnostic diagnostic, uint32_t parent = DiagnosticRecord::NoParent);
+  void addAll(LibClang& api, CXDiagnosticSet set);
+  void merge(const DiagnosticList& other);
+
+  DiagnosticList& operator=(const DiagnosticList&) = delete;
+  DiagnosticList& operator=(DiagnosticList&&) = default;
+
+protected:
+  uint32_t insert(const DiagnosticRecord& record);
+};
+
+/**
+ * \brief returns whether the list is empty
+ */
+inline bool DiagnosticList::empty() const
+{
+  return records.empty();
+}
+
+/**
+ * \brief returns the number of distinct diagnostics in the list
+ */
+inline size_t DiagnosticList::size() const
+{
+  return records.size();
+}
+
+/**
+ * \brief returns the diagnostic at the given index
+ */
+inline const DiagnosticRecord& DiagnosticList::at(size_t i) const
+{
+  return records.at(i);
+}
+
+/**
+ * \brief returns the name of the file in which a diagnostic is located
+ */
+inline StringView DiagnosticList::fileName(const DiagnosticRecord& d) const
+{
+  return strings.get(d.file);
+}
+
+/**
+ * \brief returns the text of a diagnostic
+ */
+inline StringView DiagnosticList::message(const DiagnosticRecord& d) const
+{
+  return strings.get(d.message);
+}
+
+/**
+ * \brief returns the command-line option that enables a diagnostic (e.g. -Wconversion)
+ */
+inline StringView DiagnosticList::option(const DiagnosticRecord& d) const
+{
+  return strings.get(d.option);
+}
+
+LIBCLANGU_API DiagnosticList getDiagnostics(const TranslationUnit& tu);
+
+LIBCLANGU_API DiagnosticList loadDiagnostics(LibClang& api, const std::string& file);
+LIBCLANGU_API DiagnosticList loadDiagnostics(LibClang& api, const std::vector<std::string>& files, std::vector<std::string>* errors = nullptr, unsigned nb_threads = 0);
+
+} // namespace libclang
+
+#endif // LIBCLANGUTILS_CLANG_DIAGNOSTIC_H
@@ -7,6 +7,9 @@
 
 #include "libclang-utils/libclang.h"
 #include "libclang-utils/clang-source-location.h"
+#include "libclang-utils/string-view.h"
+
+#include <vector>
 
 /*!
  * \namespace libclang
@@ -15,6 +18,8 @@
 namespace libclang
 {
 
+class TranslationUnit;
+
 /*!
  * \class SourceRange
  */
@@ -54,6 +59,8 @@ public:
   SourceLocation getRangeStart() const;
   SourceLocation getRangeEnd() const;
 
+  StringView text(const TranslationUnit& tu) const;
+
   operator CXSourceRange() const;
 };
 
@@ -134,6 +141,25 @@ inline SourceRange getRange(const SourceLocation& begin, const SourceLocation& e
   return SourceRange(*begin.api, begin.api->clang_getRange(begin, end));
 }
 
+LIBCLANGU_API std::vector<StringView> getTexts(const TranslationUnit& tu, const std::vector<SourceRange>& ranges);
+
+namespace details
+{
+
+/**
+ * \brief caches the content of the last file read by range_text()
+ */
+struct FileContentsCache
+{
+  CXFile file = nullptr;
+  const char* data = nullptr;
+  size_t size = 0;
+};
+
+LIBCLANGU_API StringView range_text(LibClang& api, CXTranslationUnit tu, CXSourceRange range, FileContentsCache& cache);
+
+} // namespace details
+
 /*!
  * \endnamespace
  */
@@ -0,0 +1,127 @@
+// Copyright (C) 2023 Vincent Chambrin
+// This file is part of the 'libclang-utils' project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#ifndef LIBCLANGUTILS_CLANG_STRING_H
+#define LIBCLANGUTILS_CLANG_STRING_H
+
+#include "libclang-utils/libclang.h"
+#include "libclang-utils/string-view.h"
+
+namespace libclang
+{
+
+/**
+ * \brief owns a CXString
+ *
+ * The string is disposed when the object is destroyed.
+ * Its content can be read in place through view() or c_str(), without
+ * copying it into a std::string.
+ */
+class ClangString
+{
+private:
+  LibClang* m_api = nullptr;
+  CXString m_str;
+
+public:
+  ClangString();
+  ClangString(const ClangString&) = delete;
+  ClangString(ClangString&& other) noexcept;
+  ~ClangString();
+
+  ClangString(LibClang& api, CXString str);
+
+  const char* c_str() const;
+  StringView view() const;
+  bool empty() const;
+
+  std::string toStdString() const;
+
+  ClangString& operator=(const ClangString&) = delete;
+  ClangString& operator=(ClangString&& other) noexcept;
+};
+
+/**
+ * \brief constructs an empty string
+ */
+inline ClangString::ClangString()
+{
+  m_str.data = nullptr;
+  m_str.private_flags = 0;
+}
+
+/**
+ * \brief takes ownership of a CXString
+ */
+inline ClangString::ClangString(LibClang& api, CXString str)
+  : m_api(&api), m_str(str)
+{
+
+}
+
+inline ClangString::ClangString(ClangString&& other) noexcept
+  : m_api(other.m_api), m_str(other.m_str)
+{
+  other.m_api = nullptr;
+}
+
+inline ClangString::~ClangString()
+{
+  if (m_api)
+    m_api->clang_disposeString(m_str);
+}
+
+inline ClangString& ClangString::operator=(ClangString&& other) noexcept
+{
+  if (this != &other)
+  {
+    if (m_api)
+      m_api->clang_disposeString(m_str);
+
+    m_api = other.m_api;
+    m_str = other.m_str;
+    other.m_api = nullptr;
+  }
+
+  return *this;
+}
+
+/**
+ * \brief returns the null-terminated content of the string
+ *
+ * This never returns a null pointer.
+ */
+inline const char* ClangString::c_str() const
+{
+  const char* str = m_api ? m_api->clang_getCString(m_str) : nullptr;
+  return str ? str : "";
+}
+
+/**
+ * \brief returns a view over the content of the string
+ */
+inline StringView ClangString::view() const
+{
+  return StringView(c_str());
+}
+
+/**
+ * \brief returns whether the string is empty
+ */
+inline bool ClangString::empty() const
+{
+  return *c_str() == '\0';
+}
+
+/**
+ * \brief copies the string into a std::string
+ */
+inline std::string ClangString::toStdString() const
+{
+  return std::string(c_str());
+}
+
+} // namespace libclang
+
+#endif // LIBCLANGUTILS_CLANG_STRING_H
@@ -7,8 +7,10 @@
 
 #include "libclang-utils/libclang.h"
 #include "libclang-utils/clang-source-range.h"
+#include "libclang-utils/string-view.h"
 
 #include <functional>
+#include <vector>
 
 namespace libclang
 {
@@ -36,6 +38,7 @@ public:
   const std::string& getKindSpelling() const;
 
   std::string getSpelling() const;
+  StringView text() const;
 
   SourceLocation getLocation() const;
   SourceRange getExtent() const;
@@ -87,6 +90,7 @@ public:
   Token at(size_t i) const;
 
   std::string getSpelling() const;
+  std::vector<StringView> texts() const;
 };
 
 /**
@@ -20,6 +20,7 @@ class TokenSet;
 class File;
 class SourceLocation;
 class SourceRange;
+class SkippedRanges;
 
 /*!
  * \class TranslationUnit
@@ -75,6 +76,9 @@ public:
   bool isFileMultipleIncludeGuarded(const File& f) const;
   const char* getFileContents(const File& f, size_t* bufsize = nullptr) const;
 
+  SkippedRanges skippedRanges(const File& f) const;
+  SkippedRanges allSkippedRanges() const;
+
   operator CXTranslationUnit() const;
 };
 
@@ -0,0 +1,131 @@
+// Copyright (C) 2023 Vincent Chambrin
+// This file is part of the 'libclang-utils' project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#ifndef LIBCLANGUTILS_CLASSHIERARCHY_H
+#define LIBCLANGUTILS_CLASSHIERARCHY_H
+
+#include "libclang-utils/symbol-adjacency.h"
+
+#include <vector>
+
+namespace libclang
+{
+
+class TranslationUnit;
+
+/**
+ * \brief an index of the base classes and of the overridden methods
+ *
+ * Classes and methods are identified by the SymbolKey of their USR,
+ * so indexes built from different translation units can be merged.
+ *
+ * The index records the direct base classes of each class (from the
+ * CXXBaseSpecifier children of the class) and the methods directly
+ * overridden by each method, destructor or conversion function (from
+ * clang_getOverriddenCursors()).
+ * Both relations and their inverses are stored as SymbolAdjacency, so
+ * that queries in either direction don't require scanning the index.
+ *
+ * Dependent base classes that don't resolve to a declaration are not
+ * recorded.
+ */
+class LIBCLANGU_API ClassHierarchy
+{
+private:
+  std::vector<SymbolEdge> m_inheritance;
+  std::vector<SymbolEdge> m_overrides;
+  SymbolAdjacency m_bases;
+  SymbolAdjacency m_derived;
+  SymbolAdjacency m_overridden;
+  SymbolAdjacency m_overriders;
+
+public:
+  ClassHierarchy() = default;
+  ClassHierarchy(const ClassHierarchy&) = default;
+  ClassHierarchy(ClassHierarchy&&) = default;
+  ~ClassHierarchy() = default;
+
+  explicit ClassHierarchy(const TranslationUnit& tu);
+
+  bool empty() const;
+
+  const std::vector<SymbolEdge>& inheritance() const;
+  const std::vector<SymbolEdge>& overrides() const;
+
+  ArrayView<SymbolKey> bases(SymbolKey c) const;
+  ArrayView<SymbolKey> derivedClasses(SymbolKey c) const;
+  std::vector<SymbolKey> allDerivedClasses(SymbolKey c) const;
+
+  ArrayView<SymbolKey> overriddenMethods(SymbolKey m) const;
+  ArrayView<SymbolKey> overridingMethods(SymbolKey m) const;
+
+  void merge(const ClassHierarchy& other);
+  void merge(const std::vector<const ClassHierarchy*>& others);
+
+  ClassHierarchy& operator=(const ClassHierarchy&) = default;
+  ClassHierarchy& operator=(ClassHierarchy&&) = default;
+
+protected:
+  void build();
+};
+
+/**
+ * \brief returns whether the index has neither inheritance nor override
+ */
+inline bool ClassHierarchy::empty() const
+{
+  return m_inheritance.empty() && m_overrides.empty();
+}
+
+/**
+ * \brief returns the (derived, base) pairs, sorted
+ */
+inline const std::vector<SymbolEdge>& ClassHierarchy::inheritance() const
+{
+  return m_inheritance;
+}
+
+/**
+ * \brief returns the (method, overridden method) pairs, sorted
+ */
+inline const std::vector<SymbolEdge>& ClassHierarchy::overrides() const
+{
+  return m_overrides;
+}
+
+/**
+ * \brief returns the direct base classes of a class
+ */
+inline ArrayView<SymbolKey> ClassHierarchy::bases(SymbolKey c) const
+{
+  return m_bases.targets(c);
+}
+
+/**
+ * \brief returns the classes directly derived from a class
+ */
+inline ArrayView<SymbolKey> ClassHierarchy::derivedClasses(SymbolKey c) const
+{
+  return m_derived.targets(c);
+}
+
+/**
+ * \brief returns the methods directly overridden by a method
+ */
+inline ArrayView<SymbolKey> ClassHierarchy::overriddenMethods(SymbolKey m) const
+{
+  return m_overridden.targets(m);
+}
+
+/**
+ * \brief returns the methods directly overriding a method
+ */
+inline ArrayView<SymbolKey> ClassHierarchy::overridingMethods(SymbolKey m) const
+{
+  return m_overriders.targets(m);
+}
+
+} // namespace libclang
+
+#endif // LIBCLANGUTILS_CLASSHIERARCHY_H
@@ -0,0 +1,140 @@
+// Copyright (C) 2023 Vincent Chambrin
+// This file is part of the 'libclang-utils' project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#ifndef LIBCLANGUTILS_CONSTANTTABLE_H
+#define LIBCLANGUTILS_CONSTANTTABLE_H
+
+#include "libclang-utils/string-table.h"
+#include "libclang-utils/symbol-key.h"
+
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+namespace libclang
+{
+
+class TranslationUnit;
+
+/**
+ * \brief the values of the constants of a translation unit
+ *
+ * The table is filled with a single traversal of the declarations of a
+ * translation unit and contains:
+ * - the enum constants, read with clang_getEnumConstantDeclValue();
+ * - the variables of const-qualified type (this includes constexpr
+ *   variables and static const members) whose initializer can be
+ *   evaluated with clang_Cursor_Evaluate().
+ *
+ * Each constant has one row, found by the SymbolKey of its declaration.
+ * Values are stored as 64-bit words interpreted according to the type
+ * of the row; string values are interned in the table.
+ *
+ * Templates are not visited, their constants may depend on template
+ * parameters.
+ */
+class LIBCLANGU_API ConstantTable
+{
+public:
+  typedef uint32_t Row;
+  static const Row NoRow = 0xFFFFFFFF;
+
+  enum ValueType : uint8_t
+  {
+    Integer,
+    UnsignedInteger,
+    Float,
+    String,
+  };
+
+public:
+  std::vector<SymbolKey> symbols;
+  std::vector<CXCursorKind> kinds;
+  std::vector<ValueType> types;
+  std::vector<uint64_t> values;
+
+  StringTable strings;
+
+private:
+  std::unordered_map<SymbolKey, Row> m_rows;
+
+public:
+  ConstantTable() = default;
+  ConstantTable(const ConstantTable&) = delete;
+  ConstantTable(ConstantTable&&) = default;
+  ~ConstantTable() = default;
+
+  explicit ConstantTable(const TranslationUnit& tu);
+
+  bool empty() const;
+  size_t size() const;
+
+  Row find(SymbolKey symbol) const;
+
+  long long toInt(Row row) const;
+  unsigned long long toUnsigned(Row row) const;
+  double toDouble(Row row) const;
+  StringView toString(Row row) const;
+
+  ConstantTable& operator=(const ConstantTable&) = delete;
+  ConstantTable& operator=(ConstantTable&&) = default;
+
+protected:
+  void add(SymbolKey symbol, CXCursorKind kind, ValueType type, uint64_t value);
+};
+
+/**
+ * \brief returns whether the table has no constant
+ */
+inline bool ConstantTable::empty() const
+{
+  return symbols.empty();
+}
+
+/**
+ * \brief returns the number of constants in the table
+ */
+inline size_t ConstantTable::size() const
+{
+  return symbols.size();
+}
+
+/**
+ * \brief returns the value of an Integer constant
+ */
+inline long long ConstantTable::toInt(Row row) const
+{
+  return static_cast<long long>(values[row]);
+}
+
+/**
+ * \brief returns the value of an UnsignedInteger constant
+ */
+inline unsigned long long ConstantTable::toUnsigned(Row row) const
+{
+  return values[row];
+}
+
+/**
+ * \brief returns the value of a Float constant
+ */
+inline double ConstantTable::toDouble(Row row) const
+{
+  double d;
+  std::memcpy(&d, &values[row], sizeof(double));
+  return d;
+}
+
+/**
+ * \brief returns the value of a String constant
+ */
+inline StringView ConstantTable::toString(Row row) const
+{
+  return strings.get(static_cast<StringTable::Id>(values[row]));
+}
+
+} // namespace libclang
+
+#endif // LIBCLANGUTILS_CONSTANTTABLE_H
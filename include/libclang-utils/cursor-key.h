@@ -0,0 +1,84 @@
+// Copyright (C) 2023 Vincent Chambrin
+// This file is part of the 'libclang-utils' project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#ifndef LIBCLANGUTILS_CURSORKEY_H
+#define LIBCLANGUTILS_CURSORKEY_H
+
+#include "libclang-utils/cindex.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace libclang
+{
+
+/**
+ * \brief the identity of a cursor, as raw bits
+ *
+ * Two keys are equal if and only if clang_equalCursors() would return
+ * true for the cursors they were built from, but comparing or hashing
+ * keys doesn't call libclang.
+ * Like clang_equalCursors(), the "first in declaration group" pointer of
+ * declaration cursors is ignored.
+ */
+struct CursorKey
+{
+  CXCursorKind kind;
+  const void* data[3];
+
+  CursorKey() = default;
+  explicit CursorKey(const CXCursor& c);
+};
+
+inline CursorKey::CursorKey(const CXCursor& c)
+  : kind(c.kind), data{ c.data[0], c.data[1], c.data[2] }
+{
+  // same test as clang_isDeclaration()
+  if ((kind >= CXCursor_FirstDecl && kind <= CXCursor_LastDecl) ||
+      (kind >= CXCursor_FirstExtraDecl && kind <= CXCursor_LastExtraDecl))
+    data[1] = nullptr;
+}
+
+inline bool operator==(const CursorKey& lhs, const CursorKey& rhs)
+{
+  return lhs.kind == rhs.kind && lhs.data[0] == rhs.data[0] && lhs.data[1] == rhs.data[1] && lhs.data[2] == rhs.data[2];
+}
+
+inline bool operator!=(const CursorKey& lhs, const CursorKey& rhs)
+{
+  return !(lhs == rhs);
+}
+
+/**
+ * \brief returns a hash value for a cursor key
+ */
+inline size_t hashValue(const CursorKey& key)
+{
+  uint64_t h = static_cast<uint64_t>(key.kind);
+
+  for (const void* p : key.data)
+  {
+    h ^= static_cast<uint64_t>(reinterpret_cast<uintptr_t>(p));
+    h *= 0x9E3779B97F4A7C15ull;
+    h ^= h >> 29;
+  }
+
+  return static_cast<size_t>(h);
+}
+
+} // namespace libclang
+
+namespace std
+{
+template<> struct hash<libclang::CursorKey>
+{
+  std::size_t operator()(const libclang::CursorKey& key) const noexcept
+  {
+    return libclang::hashValue(key);
+  }
+};
+}
+
+#endif // LIBCLANGUTILS_CURSORKEY_H
@@ -0,0 +1,150 @@
+// Copyright (C) 2023 Vincent Chambrin
+// This file is part of the 'libclang-utils' project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#ifndef LIBCLANGUTILS_CURSORSET_H
+#define LIBCLANGUTILS_CURSORSET_H
+
+#include "libclang-utils/clang-cursor.h"
+#include "libclang-utils/cursor-key.h"
+
+#include <vector>
+
+namespace libclang
+{
+
+/**
+ * \brief a set of cursors implemented by libclang
+ *
+ * Exposes clang_createCXCursorSet() and related functions.
+ */
+class CursorSet
+{
+private:
+  LibClang* m_api = nullptr;
+  CXCursorSet m_set = nullptr;
+
+public:
+  CursorSet() = default;
+  CursorSet(const CursorSet&) = delete;
+  CursorSet(CursorSet&& other) noexcept;
+  ~CursorSet();
+
+  explicit CursorSet(LibClang& api);
+
+  bool insert(const CXCursor& c);
+  bool contains(const CXCursor& c) const;
+
+  CursorSet& operator=(const CursorSet&) = delete;
+  CursorSet& operator=(CursorSet&& other) noexcept;
+};
+
+/**
+ * \brief creates an empty set
+ */
+inline CursorSet::CursorSet(LibClang& api)
+  : m_api(&api), m_set(api.clang_createCXCursorSet())
+{
+
+}
+
+inline CursorSet::CursorSet(CursorSet&& other) noexcept
+  : m_api(other.m_api), m_set(other.m_set)
+{
+  other.m_set = nullptr;
+}
+
+inline CursorSet::~CursorSet()
+{
+  if (m_set)
+    m_api->clang_disposeCXCursorSet(m_set);
+}
+
+inline CursorSet& CursorSet::operator=(CursorSet&& other) noexcept
+{
+  if (this != &other)
+  {
+    if (m_set)
+      m_api->clang_disposeCXCursorSet(m_set);
+
+    m_api = other.m_api;
+    m_set = other.m_set;
+    other.m_set = nullptr;
+  }
+
+  return *this;
+}
+
+/**
+ * \brief inserts a cursor in the set
+ * \return true if the cursor was not already in the set
+ */
+inline bool CursorSet::insert(const CXCursor& c)
+{
+  return m_api->clang_CXCursorSet_insert(m_set, c) != 0;
+}
+
+/**
+ * \brief returns whether a cursor is in the set
+ */
+inline bool CursorSet::contains(const CXCursor& c) const
+{
+  return m_api->clang_CXCursorSet_contains(m_set, c) != 0;
+}
+
+/**
+ * \brief a set of cursors implemented with open addressing
+ *
+ * Cursors are stored as CursorKey in a flat array with linear probing:
+ * hashing and comparing cursors doesn't call libclang.
+ * Two cursors are considered equal if clang_equalCursors() would return
+ * true for them.
+ */
+class LIBCLANGU_API FlatCursorSet
+{
+private:
+  std::vector<CursorKey> m_slots;
+  size_t m_size = 0;
+
+public:
+  FlatCursorSet() = default;
+  FlatCursorSet(const FlatCursorSet&) = default;
+  FlatCursorSet(FlatCursorSet&&) = default;
+  ~FlatCursorSet() = default;
+
+  bool empty() const;
+  size_t size() const;
+
+  void reserve(size_t n);
+  void clear();
+
+  bool insert(const CXCursor& c);
+  bool contains(const CXCursor& c) const;
+
+  FlatCursorSet& operator=(const FlatCursorSet&) = default;
+  FlatCursorSet& operator=(FlatCursorSet&&) = default;
+
+protected:
+  size_t probe(const CursorKey& key) const;
+  void rehash(size_t capacity);
+};
+
+/**
+ * \brief returns whether the set is empty
+ */
+inline bool FlatCursorSet::empty() const
+{
+  return m_size == 0;
+}
+
+/**
+ * \brief returns the number of cursors in the set
+ */
+inline size_t FlatCursorSet::size() const
+{
+  return m_size;
+}
+
+} // namespace libclang
+
+#endif // LIBCLANGUTILS_CURSORSET_H
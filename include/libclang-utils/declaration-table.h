@@ -0,0 +1,210 @@
+// Copyright (C) 2023 Vincent Chambrin
+// This file is part of the 'libclang-utils' project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#ifndef LIBCLANGUTILS_DECLARATIONTABLE_H
+#define LIBCLANGUTILS_DECLARATIONTABLE_H
+
+#include "libclang-utils/libclang.h"
+#include "libclang-utils/string-table.h"
+#include "libclang-utils/symbol-key.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace libclang
+{
+
+class DocCommentCache;
+class ThreadPool;
+class TranslationUnit;
+
+/**
+ * \brief the attributes of the declarations of one or more translation units
+ *
+ * The table is filled with a single traversal per translation unit and
+ * stores one row per declaration in parallel arrays.
+ * Only the columns selected by the field mask are filled (the others
+ * stay empty) and only the libclang functions needed by these fields
+ * are called.
+ * Strings (names, type spellings, file names and comments) are interned
+ * in the table and read directly from the buffers returned by libclang.
+ *
+ * Documentation comments can be looked up in a DocCommentCache shared by
+ * several tables, so that the comments of declarations found in headers
+ * are extracted once for all the translation units including them.
+ *
+ * Declarations inside function bodies are not recorded.
+ * Rows of the i-th translation unit are the rows in the range
+ * [unit_offsets[i], unit_offsets[i + 1]).
+ */
+class LIBCLANGU_API DeclarationTable
+{
+public:
+  enum Field
+  {
+    Name = 0x01,
+    Kind = 0x02,
+    Access = 0x04,
+    TypeSpelling = 0x08,
+    Location = 0x10,
+    DefinitionFlag = 0x20,
+    Symbol = 0x40,
+    RawComment = 0x80,
+    BriefComment = 0x100,
+    AllFields = 0x1FF,
+  };
+
+  enum Option
+  {
+    NoOption = 0,
+    MainFileOnly = 0x01,
+  };
+
+public:
+  unsigned fields = 0;
+
+  std::vector<StringTable::Id> names;
+  std::vector<CXCursorKind> kinds;
+  std::vector<CX_CXXAccessSpecifier> accesses;
+  std::vector<StringTable::Id> types;
+  std::vector<StringTable::Id> files;
+  std::vector<unsigned> lines;
+  std::vector<unsigned> columns;
+  std::vector<unsigned> offsets;
+  std::vector<uint8_t> definitions;
+  std::vector<SymbolKey> symbols;
+  std::vector<StringTable::Id> raw_comments;
+  std::vector<StringTable::Id> brief_comments;
+
+  std::vector<uint32_t> unit_offsets;
+
+  StringTable strings;
+
+public:
+  DeclarationTable();
+  DeclarationTable(const DeclarationTable&) = delete;
+  DeclarationTable(DeclarationTable&&) = default;
+  ~DeclarationTable() = default;
+
+  explicit DeclarationTable(unsigned fields);
+  DeclarationTable(const TranslationUnit& tu, unsigned fields, unsigned options = NoOption);
+
+  bool empty() const;
+  size_t size() const;
+  size_t unitCount() const;
+
+  bool has(Field f) const;
+
+  StringView name(size_t row) const;
+  StringView type(size_t row) const;
+  StringView file(size_t row) const;
+  bool isDefinition(size_t row) const;
+  StringView rawComment(size_t row) const;
+  StringView briefComment(size_t row) const;
+
+  void extract(const TranslationUnit& tu, unsigned options = NoOption, DocCommentCache* comments = nullptr);
+  void append(const DeclarationTable& other);
+
+  DeclarationTable& operator=(const DeclarationTable&) = delete;
+  DeclarationTable& operator=(DeclarationTable&&) = default;
+};
+
+LIBCLANGU_API DeclarationTable extractDeclarations(ThreadPool& pool, const std::vector<const TranslationUnit*>& units,
+  unsigned fields, unsigned options = DeclarationTable::NoOption, DocCommentCache* comments = nullptr);
+
+/**
+ * \brief returns whether the table has no row
+ */
+inline bool DeclarationTable::empty() const
+{
+  return size() == 0;
+}
+
+/**
+ * \brief returns the number of declarations in the table
+ */
+inline size_t DeclarationTable::size() const
+{
+  return unit_offsets.back();
+}
+
+/**
+ * \brief returns the number of translation units the table was filled from
+ */
+inline size_t DeclarationTable::unitCount() const
+{
+  return unit_offsets.size() - 1;
+}
+
+/**
+ * \brief returns whether a column is filled
+ */
+inline bool DeclarationTable::has(Field f) const
+{
+  return (fields & f) == static_cast<unsigned>(f);
+}
+
+/**
+ * \brief returns the name of a declaration
+ *
+ * Requires the Name field.
+ */
+inline StringView DeclarationTable::name(size_t row) const
+{
+  return strings.get(names[row]);
+}
+
+/**
+ * \brief returns the spelling of the type of a declaration
+ *
+ * Requires the TypeSpelling field.
+ */
+inline StringView DeclarationTable::type(size_t row) const
+{
+  return strings.get(types[row]);
+}
+
+/**
+ * \brief returns the name of the file of a declaration
+ *
+ * Requires the Location field.
+ */
+inline StringView DeclarationTable::file(size_t row) const
+{
+  return strings.get(files[row]);
+}
+
+/**
+ * \brief returns whether a declaration is a definition
+ *
+ * Requires the DefinitionFlag field.
+ */
+inline bool DeclarationTable::isDefinition(size_t row) const
+{
+  return definitions[row] != 0;
+}
+
+/**
+ * \brief returns the documentation comment of a declaration
+ *
+ * Requires the RawComment field.
+ */
+inline StringView DeclarationTable::rawComment(size_t row) const
+{
+  return strings.get(raw_comments[row]);
+}
+
+/**
+ * \brief returns the brief documentation comment of a declaration
+ *
+ * Requires the BriefComment field.
+ */
+inline StringView DeclarationTable::briefComment(size_t row) const
+{
+  return strings.get(brief_comments[row]);
+}
+
+} // namespace libclang
+
+#endif // LIBCLANGUTILS_DECLARATIONTABLE_H
@@ -0,0 +1,69 @@
+// Copyright (C) 2023 Vincent Chambrin
+// This file is part of the 'libclang-utils' project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#ifndef LIBCLANGUTILS_DOCCOMMENTCACHE_H
+#define LIBCLANGUTILS_DOCCOMMENTCACHE_H
+
+#include "libclang-utils/string-table.h"
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+
+namespace libclang
+{
+
+/**
+ * \brief a thread-safe cache of documentation comments
+ *
+ * Comments are identified by a 64-bit key computed from the position of
+ * the declaration they are attached to (the unique id of its file and its
+ * offset), so that a declaration of a header seen by several translation
+ * units has the same key in all of them and its comment is only extracted
+ * once.
+ *
+ * The strings are stored in an internal StringTable: views returned by
+ * the cache remain valid as long as the cache exists.
+ */
+class LIBCLANGU_API DocCommentCache
+{
+public:
+  struct Comment
+  {
+    StringView raw;
+    StringView brief;
+  };
+
+private:
+  mutable std::mutex m_mutex;
+  StringTable m_strings;
+  std::unordered_map<uint64_t, std::pair<StringTable::Id, StringTable::Id>> m_comments;
+  mutable std::atomic<size_t> m_hits{ 0 };
+
+public:
+  DocCommentCache() = default;
+  DocCommentCache(const DocCommentCache&) = delete;
+  ~DocCommentCache() = default;
+
+  size_t size() const;
+  size_t hits() const;
+
+  bool find(uint64_t key, Comment& comment) const;
+  Comment insert(uint64_t key, StringView raw, StringView brief);
+
+  DocCommentCache& operator=(const DocCommentCache&) = delete;
+};
+
+/**
+ * \brief returns the number of successful calls to find()
+ */
+inline size_t DocCommentCache::hits() const
+{
+  return m_hits.load();
+}
+
+} // namespace libclang
+
+#endif // LIBCLANGUTILS_DOCCOMMENTCACHE_H
@@ -0,0 +1,159 @@
+// Copyright (C) 2023 Vincent Chambrin
+// This file is part of the 'libclang-utils' project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#ifndef LIBCLANGUTILS_EVALRESULT_H
+#define LIBCLANGUTILS_EVALRESULT_H
+
+#include "libclang-utils/libclang.h"
+#include "libclang-utils/string-view.h"
+
+namespace libclang
+{
+
+class Cursor;
+
+/**
+ * \brief owns the result of the evaluation of a cursor
+ *
+ * Exposes clang_Cursor_Evaluate() and the clang_EvalResult_* functions.
+ * A null result (see isNull()) is produced when the cursor cannot be
+ * evaluated.
+ */
+class LIBCLANGU_API EvalResult
+{
+public:
+  LibClang* api = nullptr;
+  CXEvalResult result = nullptr;
+
+public:
+  EvalResult() = default;
+  EvalResult(const EvalResult&) = delete;
+  EvalResult(EvalResult&& other) noexcept;
+  ~EvalResult();
+
+  EvalResult(LibClang& lib, CXEvalResult r);
+  explicit EvalResult(const Cursor& c);
+
+  bool isNull() const;
+
+  CXEvalResultKind kind() const;
+  bool isUnsignedInt() const;
+  int asInt() const;
+  long long asLongLong() const;
+  unsigned long long asUnsigned() const;
+  double asDouble() const;
+  StringView asStr() const;
+
+  EvalResult& operator=(const EvalResult&) = delete;
+  EvalResult& operator=(EvalResult&& other) noexcept;
+};
+
+/**
+ * \brief takes ownership of a CXEvalResult
+ */
+inline EvalResult::EvalResult(LibClang& lib, CXEvalResult r)
+  : api(&lib), result(r)
+{
+
+}
+
+inline EvalResult::EvalResult(EvalResult&& other) noexcept
+  : api(other.api), result(other.result)
+{
+  other.result = nullptr;
+}
+
+inline EvalResult::~EvalResult()
+{
+  if (result)
+    api->clang_EvalResult_dispose(result);
+}
+
+inline EvalResult& EvalResult::operator=(EvalResult&& other) noexcept
+{
+  if (this != &other)
+  {
+    if (result)
+      api->clang_EvalResult_dispose(result);
+
+    api = other.api;
+    result = other.result;
+    other.result = nullptr;
+  }
+
+  return *this;
+}
+
+/**
+ * \brief returns whether the evaluation failed
+ */
+inline bool EvalResult::isNull() const
+{
+  return result == nullptr;
+}
+
+/**
+ * \brief returns the kind of the result
+ *
+ * A null result has kind CXEval_UnExposed.
+ */
+inline CXEvalResultKind EvalResult::kind() const
+{
+  return result ? api->clang_EvalResult_getKind(result) : CXEval_UnExposed;
+}
+
+/**
+ * \brief returns whether an integer result is unsigned
+ */
+inline bool EvalResult::isUnsignedInt() const
+{
+  return api->clang_EvalResult_isUnsignedInt(result);
+}
+
+/**
+ * \brief returns an integer result as an int
+ */
+inline int EvalResult::asInt() const
+{
+  return api->clang_EvalResult_getAsInt(result);
+}
+
+/**
+ * \brief returns an integer result as a long long
+ */
+inline long long EvalResult::asLongLong() const
+{
+  return api->clang_EvalResult_getAsLongLong(result);
+}
+
+/**
+ * \brief returns an unsigned integer result
+ */
+inline unsigned long long EvalResult::asUnsigned() const
+{
+  return api->clang_EvalResult_getAsUnsigned(result);
+}
+
+/**
+ * \brief returns a floating-point result
+ */
+inline double EvalResult::asDouble() const
+{
+  return api->clang_EvalResult_getAsDouble(result);
+}
+
+/**
+ * \brief returns a string result
+ *
+ * The view remains valid as long as this object exists.
+ */
+inline StringView EvalResult::asStr() const
+{
+  const char* str = api->clang_EvalResult_getAsStr(result);
+  return str ? StringView(str) : StringView();
+}
+
+} // namespace libclang
+
+#endif // LIBCLANGUTILS_EVALRESULT_H
@@ -0,0 +1,105 @@
+// Copyright (C) 2023 Vincent Chambrin
+// This file is part of the 'libclang-utils' project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#ifndef LIBCLANGUTILS_EXTENTINDEX_H
+#define LIBCLANGUTILS_EXTENTINDEX_H
+
+#include "libclang-utils/ast-snapshot.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace libclang
+{
+
+/**
+ * \brief lists of nodes stored contiguously
+ *
+ * The i-th list is nodes[offsets[i] .. offsets[i + 1]).
+ */
+struct NodeLists
+{
+  std::vector<uint32_t> offsets;
+  std::vector<AstSnapshot::NodeId> nodes;
+
+  size_t size() const { return offsets.empty() ? 0 : offsets.size() - 1; }
+  size_t count(size_t i) const { return offsets[i + 1] - offsets[i]; }
+  AstSnapshot::NodeId at(size_t i, size_t j) const { return nodes[offsets[i] + j]; }
+};
+
+/**
+ * \brief an index of the extents of the nodes of a snapshot
+ *
+ * The index stores, for each file, the extents [begin, end) of the nodes
+ * sorted by start offset, outer nodes first, together with a link to
+ * the innermost extent enclosing each of them.
+ *
+ * This makes it possible to find the innermost node at an offset without
+ * calling clang_getCursor(): a single query is a binary search followed
+ * by a walk up the enclosing links, and a sorted batch of offsets is
+ * answered with a single linear sweep.
+ *
+ * Node extents are assumed to be properly nested, which is the case
+ * except for some nodes produced by macro expansions.
+ */
+class LIBCLANGU_API ExtentIndex
+{
+public:
+  typedef AstSnapshot::NodeId NodeId;
+  static const uint32_t NoInterval = 0xFFFFFFFF;
+
+  struct Interval
+  {
+    unsigned begin;
+    unsigned end;
+    NodeId node;
+    uint32_t enclosing; // index of the enclosing interval, or NoInterval
+  };
+
+private:
+  std::vector<std::vector<Interval>> m_files;
+
+public:
+  ExtentIndex() = default;
+  ExtentIndex(const ExtentIndex&) = default;
+  ExtentIndex(ExtentIndex&&) = default;
+  ~ExtentIndex() = default;
+
+  explicit ExtentIndex(const AstSnapshot& snapshot);
+
+  size_t fileCount() const;
+  const std::vector<Interval>& intervals(FileTable::Id file) const;
+
+  NodeId innermost(FileTable::Id file, unsigned offset) const;
+  std::vector<NodeId> enclosing(FileTable::Id file, unsigned offset) const;
+
+  std::vector<NodeId> innermost(FileTable::Id file, const std::vector<unsigned>& offsets) const;
+  NodeLists enclosing(FileTable::Id file, const std::vector<unsigned>& offsets) const;
+
+  ExtentIndex& operator=(const ExtentIndex&) = default;
+  ExtentIndex& operator=(ExtentIndex&&) = default;
+
+protected:
+  uint32_t find(const std::vector<Interval>& intervals, unsigned offset) const;
+};
+
+/**
+ * \brief returns the number of files in the index
+ */
+inline size_t ExtentIndex::fileCount() const
+{
+  return m_files.size();
+}
+
+/**
+ * \brief returns the sorted intervals of a file
+ */
+inline const std::vector<ExtentIndex::Interval>& ExtentIndex::intervals(FileTable::Id file) const
+{
+  return m_files.at(file);
+}
+
+} // namespace libclang
+
+#endif // LIBCLANGUTILS_EXTENTINDEX_H
@@ -0,0 +1,160 @@
+// Copyright (C) 2023 Vincent Chambrin
+// This file is part of the 'libclang-utils' project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#ifndef LIBCLANGUTILS_FILETABLE_H
+#define LIBCLANGUTILS_FILETABLE_H
+
+#include "libclang-utils/libclang.h"
+#include "libclang-utils/string-table.h"
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace libclang
+{
+
+class TranslationUnit;
+
+namespace details
+{
+
+struct FileUniqueIDHash
+{
+  std::size_t operator()(const CXFileUniqueID& id) const noexcept
+  {
+    return static_cast<std::size_t>(id.data[0] * 31 + id.data[1] * 17 + id.data[2]);
+  }
+};
+
+struct FileUniqueIDEqual
+{
+  bool operator()(const CXFileUniqueID& lhs, const CXFileUniqueID& rhs) const noexcept
+  {
+    return lhs.data[0] == rhs.data[0] && lhs.data[1] == rhs.data[1] && lhs.data[2] == rhs.data[2];
+  }
+};
+
+} // namespace details
+
+/**
+ * \brief assigns a dense integer id to each file of a translation unit
+ *
+ * The table is built once from clang_getInclusions() and files are
+ * identified by their CXFileUniqueID, so that two CXFile referring to the
+ * same file on disk get the same id.
+ * Ids are assigned in inclusion order, the main file having id 0.
+ *
+ * Looking up the id of a CXFile is a hash-table lookup and doesn't
+ * involve any string comparison.
+ */
+class LIBCLANGU_API FileTable
+{
+public:
+  typedef uint32_t Id;
+  static const Id NoFile = 0xFFFFFFFF;
+
+  struct Entry
+  {
+    CXFile file;
+    CXFileUniqueID unique_id;
+    StringTable::Id name;
+    size_t size;
+    unsigned depth; // 0 for the main file, 1 for the files it includes, etc...
+  };
+
+private:
+  LibClang* m_api = nullptr;
+  StringTable m_names;
+  std::vector<Entry> m_files;
+  std::unordered_map<CXFile, Id> m_by_handle;
+  std::unordered_map<CXFileUniqueID, Id, details::FileUniqueIDHash, details::FileUniqueIDEqual> m_by_unique_id;
+
+public:
+  FileTable() = default;
+  FileTable(const FileTable&) = delete;
+  FileTable(FileTable&&) = default;
+  ~FileTable() = default;
+
+  explicit FileTable(const TranslationUnit& tu);
+
+  bool empty() const;
+  size_t size() const;
+  const Entry& at(Id id) const;
+
+  Id find(CXFile file) const;
+
+  CXFile file(Id id) const;
+  StringView name(Id id) const;
+  size_t fileSize(Id id) const;
+  unsigned depth(Id id) const;
+
+  Id insert(const TranslationUnit& tu, CXFile file, unsigned depth);
+
+  FileTable& operator=(const FileTable&) = delete;
+  FileTable& operator=(FileTable&&) = default;
+};
+
+/**
+ * \brief returns whether the table is empty
+ */
+inline bool FileTable::empty() const
+{
+  return m_files.empty();
+}
+
+/**
+ * \brief returns the number of files in the table
+ */
+inline size_t FileTable::size() const
+{
+  return m_files.size();
+}
+
+/**
+ * \brief returns the entry associated with a file id
+ */
+inline const FileTable::Entry& FileTable::at(Id id) const
+{
+  return m_files.at(id);
+}
+
+/**
+ * \brief returns the CXFile associated with a file id
+ */
+inline CXFile FileTable::file(Id id) const
+{
+  return m_files[id].file;
+}
+
+/**
+ * \brief returns the name of a file
+ */
+inline StringView FileTable::name(Id id) const
+{
+  return m_names.get(m_files[id].name);
+}
+
+/**
+ * \brief returns the size in bytes of a file
+ */
+inline size_t FileTable::fileSize(Id id) const
+{
+  return m_files[id].size;
+}
+
+/**
+ * \brief returns the include depth of a file
+ *
+ * The main file has a depth of 0.
+ * If a file is included several times, this is the depth of its first inclusion.
+ */
+inline unsigned FileTable::depth(Id id) const
+{
+  return m_files[id].depth;
+}
+
+} // namespace libclang
+
+#endif // LIBCLANGUTILS_FILETABLE_H
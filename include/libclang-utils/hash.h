@@ -0,0 +1,43 @@
+// Copyright (C) 2023 Vincent Chambrin
+// This file is part of the 'libclang-utils' project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#ifndef LIBCLANGUTILS_HASH_H
+#define LIBCLANGUTILS_HASH_H
+
+#include "libclang-utils/libclang-utils-defs.h"
+#include "libclang-utils/string-view.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace libclang
+{
+
+LIBCLANGU_API uint64_t hash64(const void* data, size_t size, uint64_t seed = 0);
+
+/**
+ * \brief computes the 64-bit hash of a string
+ */
+inline uint64_t hash64(StringView str, uint64_t seed = 0)
+{
+  return hash64(str.data(), str.size(), seed);
+}
+
+/**
+ * \brief mixes a value into a hash
+ *
+ * The result depends on the order in which values are combined.
+ */
+inline uint64_t hashCombine(uint64_t h, uint64_t value)
+{
+  h ^= value + 0x9E3779B97F4A7C15ull + (h << 6) + (h >> 2);
+  h ^= h >> 33;
+  h *= 0xC2B2AE3D27D4EB4Full;
+  h ^= h >> 29;
+  return h;
+}
+
+} // namespace libclang
+
+#endif // LIBCLANGUTILS_HASH_H
@@ -0,0 +1,116 @@
+// Copyright (C) 2023 Vincent Chambrin
+// This file is part of the 'libclang-utils' project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#ifndef LIBCLANGUTILS_LINEINDEX_H
+#define LIBCLANGUTILS_LINEINDEX_H
+
+#include "libclang-utils/libclang-utils-defs.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace libclang
+{
+
+class File;
+class TranslationUnit;
+
+/**
+ * \brief a line and column pair
+ *
+ * Lines and columns start at 1 and columns are counted in bytes, as
+ * done by libclang.
+ */
+struct LineColumn
+{
+  unsigned line;
+  unsigned column;
+};
+
+/**
+ * \brief an index of the line starts of a file
+ *
+ * The index is built once from the content of a file with a vectorized
+ * scan for line breaks (AVX2 or SSE2 when available).
+ * Afterwards, offsets can be converted to (line, column) pairs and back
+ * without calling libclang.
+ *
+ * Like clang, "\n", "\r", "\r\n" and "\n\r" are all recognized as line breaks.
+ *
+ * The index keeps a pointer to the buffer it was built from but does not
+ * require it to stay alive for conversions.
+ */
+class LIBCLANGU_API LineIndex
+{
+private:
+  const char* m_data = nullptr;
+  size_t m_size = 0;
+  std::vector<unsigned> m_line_starts;
+
+public:
+  LineIndex();
+  LineIndex(const LineIndex&) = default;
+  LineIndex(LineIndex&&) = default;
+  ~LineIndex() = default;
+
+  LineIndex(const char* data, size_t size);
+  LineIndex(const TranslationUnit& tu, const File& file);
+
+  const char* data() const;
+  size_t size() const;
+
+  size_t lineCount() const;
+  unsigned lineStart(unsigned line) const;
+
+  LineColumn lineColumn(unsigned offset) const;
+  unsigned offset(unsigned line, unsigned column) const;
+  unsigned offset(const LineColumn& pos) const;
+
+  LineIndex& operator=(const LineIndex&) = default;
+  LineIndex& operator=(LineIndex&&) = default;
+};
+
+/**
+ * \brief returns the buffer the index was built from
+ */
+inline const char* LineIndex::data() const
+{
+  return m_data;
+}
+
+/**
+ * \brief returns the size of the buffer the index was built from
+ */
+inline size_t LineIndex::size() const
+{
+  return m_size;
+}
+
+/**
+ * \brief returns the number of lines
+ *
+ * An empty buffer has one (empty) line.
+ */
+inline size_t LineIndex::lineCount() const
+{
+  return m_line_starts.size();
+}
+
+/**
+ * \brief converts a (line, column) pair to an offset
+ */
+inline unsigned LineIndex::offset(const LineColumn& pos) const
+{
+  return offset(pos.line, pos.column);
+}
+
+namespace details
+{
+LIBCLANGU_API void scan_line_starts(const char* data, size_t size, std::vector<unsigned>& line_starts);
+LIBCLANGU_API void scan_line_starts_scalar(const char* data, size_t size, std::vector<unsigned>& line_starts);
+} // namespace details
+
+} // namespace libclang
+
+#endif // LIBCLANGUTILS_LINEINDEX_H
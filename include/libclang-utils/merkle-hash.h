@@ -0,0 +1,29 @@
+// Copyright (C) 2023 Vincent Chambrin
+// This file is part of the 'libclang-utils' project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#ifndef LIBCLANGUTILS_MERKLEHASH_H
+#define LIBCLANGUTILS_MERKLEHASH_H
+
+#include "libclang-utils/clang-cursor.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace libclang
+{
+
+class AstSnapshot;
+
+LIBCLANGU_API uint64_t structuralHash(const Cursor& c);
+LIBCLANGU_API std::vector<uint64_t> structuralHashes(const AstSnapshot& snapshot);
+
+namespace details
+{
+LIBCLANGU_API std::string normalize_spelling(std::string spelling);
+} // namespace details
+
+} // namespace libclang
+
+#endif // LIBCLANGUTILS_MERKLEHASH_H
@@ -0,0 +1,116 @@
+// Copyright (C) 2023 Vincent Chambrin
+// This file is part of the 'libclang-utils' project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#ifndef LIBCLANGUTILS_NODETABLE_H
+#define LIBCLANGUTILS_NODETABLE_H
+
+#include "libclang-utils/clang-cursor.h"
+#include "libclang-utils/cursor-key.h"
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace libclang
+{
+
+class AstSnapshot;
+class TokenSet;
+class TranslationUnit;
+
+/**
+ * \brief maps the cursors of a translation unit to 4-byte handles
+ *
+ * A Cursor holds a pointer to the LibClang instance and a full CXCursor,
+ * that is about 40 bytes; containers of NodeId are therefore much more
+ * compact than containers of Cursor.
+ * The table stores each distinct cursor once and converts handles back to
+ * cursors when needed.
+ *
+ * When built from an AstSnapshot, the handle of a node of the snapshot is
+ * its node id.
+ */
+class LIBCLANGU_API NodeTable
+{
+public:
+  typedef uint32_t NodeId;
+  static const NodeId NoNode = 0xFFFFFFFF;
+
+private:
+  LibClang* m_api = nullptr;
+  std::vector<CXCursor> m_cursors;
+  std::unordered_map<CursorKey, NodeId> m_ids;
+
+public:
+  NodeTable() = default;
+  NodeTable(const NodeTable&) = delete;
+  NodeTable(NodeTable&&) = default;
+  ~NodeTable() = default;
+
+  explicit NodeTable(LibClang& api);
+  explicit NodeTable(const AstSnapshot& snapshot);
+
+  LibClang* api() const;
+
+  bool empty() const;
+  size_t size() const;
+
+  NodeId insert(const CXCursor& c);
+  NodeId find(const CXCursor& c) const;
+
+  Cursor cursor(NodeId n) const;
+  CXCursorKind kind(NodeId n) const;
+
+  std::vector<NodeId> children(NodeId n);
+  std::vector<NodeId> annotateTokens(const TranslationUnit& tu, const TokenSet& tokens);
+
+  NodeTable& operator=(const NodeTable&) = delete;
+  NodeTable& operator=(NodeTable&&) = default;
+};
+
+/**
+ * \brief returns the LibClang instance of the table
+ */
+inline LibClang* NodeTable::api() const
+{
+  return m_api;
+}
+
+/**
+ * \brief returns whether the table is empty
+ */
+inline bool NodeTable::empty() const
+{
+  return m_cursors.empty();
+}
+
+/**
+ * \brief returns the number of cursors in the table
+ */
+inline size_t NodeTable::size() const
+{
+  return m_cursors.size();
+}
+
+/**
+ * \brief returns the cursor associated with a handle
+ */
+inline Cursor NodeTable::cursor(NodeId n) const
+{
+  return Cursor(*m_api, m_cursors[n]);
+}
+
+/**
+ * \brief returns the kind of the cursor associated with a handle
+ *
+ * This doesn't call libclang.
+ */
+inline CXCursorKind NodeTable::kind(NodeId n) const
+{
+  return m_cursors[n].kind;
+}
+
+} // namespace libclang
+
+#endif // LIBCLANGUTILS_NODETABLE_H
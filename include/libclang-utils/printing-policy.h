@@ -0,0 +1,159 @@
+// Copyright (C) 2023 Vincent Chambrin
+// This file is part of the 'libclang-utils' project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#ifndef LIBCLANGUTILS_PRINTINGPOLICY_H
+#define LIBCLANGUTILS_PRINTINGPOLICY_H
+
+#include "libclang-utils/clang-string.h"
+
+namespace libclang
+{
+
+class Cursor;
+class TranslationUnit;
+
+/**
+ * \brief owns a CXPrintingPolicy
+ *
+ * A policy controls how Cursor::prettyPrinted() prints declarations.
+ * Policies are created from a cursor because they depend on the language
+ * options of its translation unit; a policy can then be used for any
+ * cursor of that translation unit.
+ *
+ * See DeclarationPrinter for a policy created once per translation unit.
+ */
+class LIBCLANGU_API PrintingPolicy
+{
+public:
+  LibClang* api = nullptr;
+  CXPrintingPolicy policy = nullptr;
+
+public:
+  PrintingPolicy() = default;
+  PrintingPolicy(const PrintingPolicy&) = delete;
+  PrintingPolicy(PrintingPolicy&& other) noexcept;
+  ~PrintingPolicy();
+
+  PrintingPolicy(LibClang& lib, CXPrintingPolicy p);
+  explicit PrintingPolicy(const Cursor& c);
+
+  static PrintingPolicy forDeclarations(const Cursor& c);
+
+  bool isNull() const;
+
+  unsigned get(CXPrintingPolicyProperty property) const;
+  void set(CXPrintingPolicyProperty property, unsigned value);
+
+  PrintingPolicy& operator=(const PrintingPolicy&) = delete;
+  PrintingPolicy& operator=(PrintingPolicy&& other) noexcept;
+
+  operator CXPrintingPolicy() const;
+};
+
+/**
+ * \brief takes ownership of a CXPrintingPolicy
+ */
+inline PrintingPolicy::PrintingPolicy(LibClang& lib, CXPrintingPolicy p)
+  : api(&lib), policy(p)
+{
+
+}
+
+inline PrintingPolicy::PrintingPolicy(PrintingPolicy&& other) noexcept
+  : api(other.api), policy(other.policy)
+{
+  other.policy = nullptr;
+}
+
+inline PrintingPolicy::~PrintingPolicy()
+{
+  if (policy)
+    api->clang_PrintingPolicy_dispose(policy);
+}
+
+inline PrintingPolicy& PrintingPolicy::operator=(PrintingPolicy&& other) noexcept
+{
+  if (this != &other)
+  {
+    if (policy)
+      api->clang_PrintingPolicy_dispose(policy);
+
+    api = other.api;
+    policy = other.policy;
+    other.policy = nullptr;
+  }
+
+  return *this;
+}
+
+/**
+ * \brief returns whether this object holds no policy
+ */
+inline bool PrintingPolicy::isNull() const
+{
+  return policy == nullptr;
+}
+
+/**
+ * \brief returns the value of a property
+ */
+inline unsigned PrintingPolicy::get(CXPrintingPolicyProperty property) const
+{
+  return api->clang_PrintingPolicy_getProperty(policy, property);
+}
+
+/**
+ * \brief sets the value of a property
+ */
+inline void PrintingPolicy::set(CXPrintingPolicyProperty property, unsigned value)
+{
+  api->clang_PrintingPolicy_setProperty(policy, property, value);
+}
+
+inline PrintingPolicy::operator CXPrintingPolicy() const
+{
+  return policy;
+}
+
+/**
+ * \brief prints the declarations of a translation unit
+ *
+ * The printer holds a policy created with PrintingPolicy::forDeclarations()
+ * when the printer is constructed, so that it is shared by all the
+ * declarations printed and is never modified afterwards; a printer can
+ * be used from several threads.
+ *
+ * The printer must not outlive the translation unit.
+ */
+class LIBCLANGU_API DeclarationPrinter
+{
+private:
+  PrintingPolicy m_policy;
+
+public:
+  DeclarationPrinter(const DeclarationPrinter&) = delete;
+  DeclarationPrinter(DeclarationPrinter&&) = default;
+  ~DeclarationPrinter() = default;
+
+  explicit DeclarationPrinter(const TranslationUnit& tu);
+
+  const PrintingPolicy& policy() const;
+
+  ClangString print(const Cursor& c) const;
+
+  DeclarationPrinter& operator=(const DeclarationPrinter&) = delete;
+  DeclarationPrinter& operator=(DeclarationPrinter&&) = default;
+};
+
+/**
+ * \brief returns the policy used to print declarations
+ */
+inline const PrintingPolicy& DeclarationPrinter::policy() const
+{
+  return m_policy;
+}
+
+} // namespace libclang
+
+#endif // LIBCLANGUTILS_PRINTINGPOLICY_H
@@ -0,0 +1,151 @@
+// Copyright (C) 2023 Vincent Chambrin
+// This file is part of the 'libclang-utils' project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#ifndef LIBCLANGUTILS_QUALIFIEDNAMECACHE_H
+#define LIBCLANGUTILS_QUALIFIEDNAMECACHE_H
+
+#include "libclang-utils/array-view.h"
+#include "libclang-utils/clang-cursor.h"
+#include "libclang-utils/cursor-key.h"
+#include "libclang-utils/string-table.h"
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace libclang
+{
+
+/**
+ * \brief computes and caches the fully qualified names of declarations
+ *
+ * Declarations are identified by their canonical cursor.
+ * The first time a declaration is looked up, its semantic parents are
+ * added to the cache as well, so the qualified name of a declaration
+ * is built from the cached name of its parent and its own spelling,
+ * and each parent chain is walked through libclang only once.
+ * extern "C" blocks and export declarations don't add a scope, anonymous
+ * namespaces are named "(anonymous namespace)" and inline namespaces are
+ * kept, like in the qualified names printed by clang.
+ *
+ * Names and ancestor chains returned by the cache are views: names remain
+ * valid as long as the cache exists, ancestor chains until the next
+ * insertion.
+ */
+class LIBCLANGU_API QualifiedNameCache
+{
+public:
+  typedef uint32_t EntryId;
+  static const EntryId NoEntry = 0xFFFFFFFF;
+
+private:
+  struct Entry
+  {
+    CXCursor cursor;
+    EntryId parent;
+    StringTable::Id name;
+    StringTable::Id qualified_name;
+    uint32_t ancestors_offset;
+    uint32_t depth;
+  };
+
+  LibClang* m_api = nullptr;
+  StringTable m_strings;
+  std::vector<Entry> m_entries;
+  std::vector<EntryId> m_ancestors;
+  std::unordered_map<CursorKey, EntryId> m_ids;
+
+public:
+  QualifiedNameCache() = default;
+  QualifiedNameCache(const QualifiedNameCache&) = delete;
+  QualifiedNameCache(QualifiedNameCache&&) = default;
+  ~QualifiedNameCache() = default;
+
+  explicit QualifiedNameCache(LibClang& api);
+
+  size_t size() const;
+
+  EntryId get(const Cursor& c);
+  EntryId find(const Cursor& c) const;
+
+  StringView qualifiedName(const Cursor& c);
+  StringView qualifiedName(EntryId id) const;
+  StringView name(EntryId id) const;
+  EntryId parent(EntryId id) const;
+  Cursor cursor(EntryId id) const;
+
+  ArrayView<EntryId> ancestors(EntryId id) const;
+
+  QualifiedNameCache& operator=(const QualifiedNameCache&) = delete;
+  QualifiedNameCache& operator=(QualifiedNameCache&&) = default;
+
+protected:
+  EntryId insert(const CXCursor& canonical, EntryId parent);
+};
+
+/**
+ * \brief returns the number of declarations in the cache
+ */
+inline size_t QualifiedNameCache::size() const
+{
+  return m_entries.size();
+}
+
+/**
+ * \brief returns the qualified name of a declaration, e.g. "ns::Class::method"
+ */
+inline StringView QualifiedNameCache::qualifiedName(const Cursor& c)
+{
+  return qualifiedName(get(c));
+}
+
+/**
+ * \brief returns the qualified name of an entry
+ */
+inline StringView QualifiedNameCache::qualifiedName(EntryId id) const
+{
+  return m_strings.get(m_entries[id].qualified_name);
+}
+
+/**
+ * \brief returns the (unqualified) name of an entry
+ */
+inline StringView QualifiedNameCache::name(EntryId id) const
+{
+  return m_strings.get(m_entries[id].name);
+}
+
+/**
+ * \brief returns the entry of the semantic parent of an entry
+ * \return the parent, or NoEntry for top-level declarations
+ */
+inline QualifiedNameCache::EntryId QualifiedNameCache::parent(EntryId id) const
+{
+  return m_entries[id].parent;
+}
+
+/**
+ * \brief returns the canonical cursor of an entry
+ */
+inline Cursor QualifiedNameCache::cursor(EntryId id) const
+{
+  return Cursor(*m_api, m_entries[id].cursor);
+}
+
+/**
+ * \brief returns the semantic ancestors of an entry
+ *
+ * Ancestors are listed from the outermost scope to the semantic parent;
+ * the translation unit is not part of the list.
+ * The view is invalidated by the next insertion in the cache.
+ */
+inline ArrayView<QualifiedNameCache::EntryId> QualifiedNameCache::ancestors(EntryId id) const
+{
+  const Entry& e = m_entries[id];
+  return ArrayView<EntryId>(m_ancestors.data() + e.ancestors_offset, e.depth);
+}
+
+} // namespace libclang
+
+#endif // LIBCLANGUTILS_QUALIFIEDNAMECACHE_H
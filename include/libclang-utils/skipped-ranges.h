@@ -0,0 +1,99 @@
+// Copyright (C) 2023 Vincent Chambrin
+// This file is part of the 'libclang-utils' project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#ifndef LIBCLANGUTILS_SKIPPEDRANGES_H
+#define LIBCLANGUTILS_SKIPPEDRANGES_H
+
+#include "libclang-utils/libclang.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace libclang
+{
+
+/**
+ * \brief a range of source code skipped by the preprocessor
+ *
+ * The range covers the offsets [begin, end) of the file identified
+ * by \a file.
+ */
+struct SkippedRange
+{
+  uint32_t file;
+  unsigned begin;
+  unsigned end;
+};
+
+/**
+ * \brief a sorted list of the ranges skipped by the preprocessor
+ *
+ * File ids are indices in the \a files vector.
+ * Ranges are sorted by file and then by offset, so that checking whether
+ * an offset is in a skipped range is a binary search.
+ */
+class LIBCLANGU_API SkippedRanges
+{
+public:
+  std::vector<CXFile> files;
+  std::vector<SkippedRange> ranges;
+
+public:
+  SkippedRanges() = default;
+  SkippedRanges(const SkippedRanges&) = default;
+  SkippedRanges(SkippedRanges&&) = default;
+  ~SkippedRanges() = default;
+
+  SkippedRanges(LibClang& api, const CXSourceRangeList& list);
+
+  bool empty() const;
+  size_t size() const;
+  const SkippedRange& at(size_t i) const;
+
+  int fileId(CXFile file) const;
+
+  const SkippedRange* find(uint32_t file, unsigned offset) const;
+  bool contains(uint32_t file, unsigned offset) const;
+
+  SkippedRanges& operator=(const SkippedRanges&) = default;
+  SkippedRanges& operator=(SkippedRanges&&) = default;
+};
+
+/**
+ * \brief returns whether there is no skipped range
+ */
+inline bool SkippedRanges::empty() const
+{
+  return ranges.empty();
+}
+
+/**
+ * \brief returns the number of skipped ranges
+ */
+inline size_t SkippedRanges::size() const
+{
+  return ranges.size();
+}
+
+/**
+ * \brief returns the skipped range at the given index
+ */
+inline const SkippedRange& SkippedRanges::at(size_t i) const
+{
+  return ranges.at(i);
+}
+
+/**
+ * \brief returns whether an offset is in a skipped range
+ * \param file    the file id
+ * \param offset  the offset in the file
+ */
+inline bool SkippedRanges::contains(uint32_t file, unsigned offset) const
+{
+  return find(file, offset) != nullptr;
+}
+
+} // namespace libclang
+
+#endif // LIBCLANGUTILS_SKIPPEDRANGES_H
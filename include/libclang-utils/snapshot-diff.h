@@ -0,0 +1,106 @@
+// Copyright (C) 2023 Vincent Chambrin
+// This file is part of the 'libclang-utils' project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#ifndef LIBCLANGUTILS_SNAPSHOTDIFF_H
+#define LIBCLANGUTILS_SNAPSHOTDIFF_H
+
+#include "libclang-utils/ast-snapshot.h"
+#include "libclang-utils/merkle-hash.h"
+#include "libclang-utils/string-table.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace libclang
+{
+
+/**
+ * \brief a summary of the declarations of a file
+ *
+ * The digest records, for each declaration of a file that is not local to
+ * a function, its USR, kind, extent and the structural hash of its
+ * subtree (see structuralHashes()).
+ *
+ * Unlike the snapshot it is computed from, the digest doesn't refer to
+ * the AST, so it remains usable after the translation unit has been
+ * reparsed or disposed.
+ */
+class LIBCLANGU_API DeclarationDigest
+{
+public:
+  struct Entry
+  {
+    StringTable::Id usr;
+    CXCursorKind kind;
+    uint64_t hash;
+    unsigned begin;
+    unsigned end;
+  };
+
+public:
+  StringTable usrs;
+  std::vector<Entry> entries;
+
+public:
+  DeclarationDigest() = default;
+  DeclarationDigest(const DeclarationDigest&) = delete;
+  DeclarationDigest(DeclarationDigest&&) = default;
+  ~DeclarationDigest() = default;
+
+  DeclarationDigest(const AstSnapshot& snapshot, FileTable::Id file);
+
+  size_t size() const;
+  StringView usr(size_t i) const;
+
+  DeclarationDigest& operator=(const DeclarationDigest&) = delete;
+  DeclarationDigest& operator=(DeclarationDigest&&) = default;
+};
+
+/**
+ * \brief returns the number of declarations in the digest
+ */
+inline size_t DeclarationDigest::size() const
+{
+  return entries.size();
+}
+
+/**
+ * \brief returns the USR of a declaration
+ */
+inline StringView DeclarationDigest::usr(size_t i) const
+{
+  return usrs.get(entries[i].usr);
+}
+
+/**
+ * \brief a change to a declaration between two digests
+ *
+ * \a before and \a after are indices in the entries of the old and new
+ * digest, or NoEntry for added and removed declarations respectively.
+ *
+ * A declaration is Moved when its structural hash is unchanged but its
+ * extent is not, e.g. because code was inserted before it.
+ */
+struct DeclarationChange
+{
+  enum Kind
+  {
+    Added,
+    Removed,
+    Changed,
+    Moved,
+  };
+
+  static const uint32_t NoEntry = 0xFFFFFFFF;
+
+  Kind kind;
+  uint32_t before;
+  uint32_t after;
+};
+
+LIBCLANGU_API std::vector<DeclarationChange> diff(const DeclarationDigest& before, const DeclarationDigest& after);
+
+} // namespace libclang
+
+#endif // LIBCLANGUTILS_SNAPSHOTDIFF_H
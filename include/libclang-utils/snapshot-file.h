@@ -0,0 +1,385 @@
+// Copyright (C) 2023 Vincent Chambrin
+// This file is part of the 'libclang-utils' project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#ifndef LIBCLANGUTILS_SNAPSHOTFILE_H
+#define LIBCLANGUTILS_SNAPSHOTFILE_H
+
+#include "libclang-utils/libclang-utils-defs.h"
+#include "libclang-utils/cindex.h"
+#include "libclang-utils/string-view.h"
+
+#include <cstdint>
+#include <string>
+
+namespace libclang
+{
+
+class AstSnapshot;
+
+/**
+ * \brief header of a snapshot file
+ *
+ * A snapshot file starts with this header, followed by \a section_count
+ * SnapshotFileSection describing where each section is.
+ * All offsets are relative to the start of the file, so that the file can
+ * be mapped at any address; sections are 8-byte aligned.
+ * Integers are stored in the byte order of the machine that wrote the
+ * file, which is recorded in \a byte_order.
+ */
+struct SnapshotFileHeader
+{
+  char magic[8];
+  uint32_t version;
+  uint32_t byte_order;
+  uint32_t node_count;
+  uint32_t file_count;
+  uint32_t section_count;
+  uint32_t reserved;
+};
+
+/**
+ * \brief identifies the sections of a snapshot file
+ *
+ * Node sections contain one 32-bit integer per node, except ChildOffsets
+ * which has an extra element.
+ * String table sections contain a count \a n, followed by n + 1 offsets and
+ * the null-terminated strings.
+ */
+enum class SnapshotSection : uint32_t
+{
+  Kinds = 1,
+  Parents,
+  FirstChildren,
+  NextSiblings,
+  SubtreeEnds,
+  ChildOffsets,
+  Children,
+  ChildIndices,
+  BeginOffsets,
+  EndOffsets,
+  FileIds,
+  Spellings,
+  Usrs,
+  Files,
+  SpellingStrings,
+  UsrStrings,
+  FileNameStrings,
+};
+
+struct SnapshotFileSection
+{
+  uint32_t id;
+  uint32_t reserved;
+  uint64_t offset;
+  uint64_t size;
+};
+
+/**
+ * \brief description of a file in a snapshot file
+ */
+struct SnapshotFileEntry
+{
+  uint32_t name;
+  uint32_t depth;
+  uint64_t size;
+};
+
+LIBCLANGU_API void saveSnapshot(const AstSnapshot& snapshot, const std::string& path);
+
+/**
+ * \brief a read-only view over a string table section
+ */
+class SnapshotStrings
+{
+private:
+  const uint32_t* m_offsets = nullptr;
+  const char* m_data = nullptr;
+  uint32_t m_count = 0;
+
+public:
+  SnapshotStrings() = default;
+  SnapshotStrings(const uint32_t* offsets, const char* data, uint32_t count);
+
+  size_t size() const;
+  StringView get(uint32_t id) const;
+};
+
+inline SnapshotStrings::SnapshotStrings(const uint32_t* offsets, const char* data, uint32_t count)
+  : m_offsets(offsets), m_data(data), m_count(count)
+{
+
+}
+
+/**
+ * \brief returns the number of strings in the table
+ */
+inline size_t SnapshotStrings::size() const
+{
+  return m_count;
+}
+
+/**
+ * \brief returns the string with the given id
+ */
+inline StringView SnapshotStrings::get(uint32_t id) const
+{
+  return StringView(m_data + m_offsets[id], m_offsets[id + 1] - m_offsets[id] - 1);
+}
+
+/**
+ * \brief a snapshot file mapped in memory
+ *
+ * The file is mapped with mmap() (MapViewOfFile() on Windows) and nodes
+ * are read directly from the mapping: opening a file only validates its
+ * header and doesn't require libclang.
+ *
+ * The accessors mirror those of AstSnapshot.
+ * Throws std::runtime_error if the file cannot be opened or is not a
+ * valid snapshot file.
+ */
+class LIBCLANGU_API SnapshotFile
+{
+public:
+  typedef uint32_t NodeId;
+  static const NodeId NoNode = 0xFFFFFFFF;
+  static const uint32_t NoFile = 0xFFFFFFFF;
+  static const uint32_t Version = 1;
+
+private:
+  const char* m_data = nullptr;
+  size_t m_size = 0;
+  void* m_file_handle = nullptr;
+  void* m_mapping_handle = nullptr;
+  const SnapshotFileHeader* m_header = nullptr;
+  const int32_t* m_kinds = nullptr;
+  const uint32_t* m_parents = nullptr;
+  const uint32_t* m_first_children = nullptr;
+  const uint32_t* m_next_siblings = nullptr;
+  const uint32_t* m_subtree_ends = nullptr;
+  const uint32_t* m_child_offsets = nullptr;
+  const uint32_t* m_children = nullptr;
+  const uint32_t* m_child_indices = nullptr;
+  const uint32_t* m_begin_offsets = nullptr;
+  const uint32_t* m_end_offsets = nullptr;
+  const uint32_t* m_file_ids = nullptr;
+  const uint32_t* m_spellings = nullptr;
+  const uint32_t* m_usrs = nullptr;
+  const SnapshotFileEntry* m_files = nullptr;
+  SnapshotStrings m_spelling_strings;
+  SnapshotStrings m_usr_strings;
+  SnapshotStrings m_file_name_strings;
+
+public:
+  SnapshotFile() = default;
+  SnapshotFile(const SnapshotFile&) = delete;
+  SnapshotFile(SnapshotFile&& other) noexcept;
+  ~SnapshotFile();
+
+  explicit SnapshotFile(const std::string& path);
+
+  bool isOpen() const;
+  void close();
+
+  size_t size() const;
+  NodeId root() const;
+
+  CXCursorKind kind(NodeId n) const;
+  NodeId parent(NodeId n) const;
+  NodeId firstChild(NodeId n) const;
+  NodeId nextSibling(NodeId n) const;
+  NodeId subtreeEnd(NodeId n) const;
+
+  size_t childCount(NodeId n) const;
+  NodeId childAt(NodeId n, size_t index) const;
+  int indexOfChild(NodeId n, NodeId child) const;
+
+  unsigned beginOffset(NodeId n) const;
+  unsigned endOffset(NodeId n) const;
+  uint32_t file(NodeId n) const;
+
+  StringView spelling(NodeId n) const;
+  StringView usr(NodeId n) const;
+
+  size_t fileCount() const;
+  StringView fileName(uint32_t id) const;
+  size_t fileSize(uint32_t id) const;
+  unsigned depth(uint32_t id) const;
+
+  SnapshotFile& operator=(const SnapshotFile&) = delete;
+  SnapshotFile& operator=(SnapshotFile&& other) noexcept;
+
+protected:
+  void open(const std::string& path);
+  void map();
+  const void* section(SnapshotSection id, uint64_t expected_size) const;
+  SnapshotStrings strings(SnapshotSection id) const;
+};
+
+/**
+ * \brief returns whether a file is mapped
+ */
+inline bool SnapshotFile::isOpen() const
+{
+  return m_data != nullptr;
+}
+
+/**
+ * \brief returns the number of nodes
+ */
+inline size_t SnapshotFile::size() const
+{
+  return m_header ? m_header->node_count : 0;
+}
+
+/**
+ * \brief returns the id of the root node
+ */
+inline SnapshotFile::NodeId SnapshotFile::root() const
+{
+  return size() > 0 ? 0 : NoNode;
+}
+
+/**
+ * \brief returns the cursor kind of a node
+ */
+inline CXCursorKind SnapshotFile::kind(NodeId n) const
+{
+  return static_cast<CXCursorKind>(m_kinds[n]);
+}
+
+/**
+ * \brief returns the parent of a node, or NoNode for the root
+ */
+inline SnapshotFile::NodeId SnapshotFile::parent(NodeId n) const
+{
+  return m_parents[n];
+}
+
+/**
+ * \brief returns the first child of a node, or NoNode
+ */
+inline SnapshotFile::NodeId SnapshotFile::firstChild(NodeId n) const
+{
+  return m_first_children[n];
+}
+
+/**
+ * \brief returns the next sibling of a node, or NoNode
+ */
+inline SnapshotFile::NodeId SnapshotFile::nextSibling(NodeId n) const
+{
+  return m_next_siblings[n];
+}
+
+/**
+ * \brief returns the id following the last descendant of a node
+ */
+inline SnapshotFile::NodeId SnapshotFile::subtreeEnd(NodeId n) const
+{
+  return m_subtree_ends[n];
+}
+
+/**
+ * \brief returns the number of children of a node
+ */
+inline size_t SnapshotFile::childCount(NodeId n) const
+{
+  return m_child_offsets[n + 1] - m_child_offsets[n];
+}
+
+/**
+ * \brief returns the child of a node at the given index
+ */
+inline SnapshotFile::NodeId SnapshotFile::childAt(NodeId n, size_t index) const
+{
+  return m_children[m_child_offsets[n] + index];
+}
+
+/**
+ * \brief returns the index of a child
+ * \return the index or -1 if \a child isn't a direct child of \a n
+ */
+inline int SnapshotFile::indexOfChild(NodeId n, NodeId child) const
+{
+  return m_parents[child] == n ? static_cast<int>(m_child_indices[child]) : -1;
+}
+
+/**
+ * \brief returns the offset of the start of the extent of a node
+ */
+inline unsigned SnapshotFile::beginOffset(NodeId n) const
+{
+  return m_begin_offsets[n];
+}
+
+/**
+ * \brief returns the offset of the end of the extent of a node
+ */
+inline unsigned SnapshotFile::endOffset(NodeId n) const
+{
+  return m_end_offsets[n];
+}
+
+/**
+ * \brief returns the file id of a node, or NoFile
+ */
+inline uint32_t SnapshotFile::file(NodeId n) const
+{
+  return m_file_ids[n];
+}
+
+/**
+ * \brief returns the spelling of a node
+ */
+inline StringView SnapshotFile::spelling(NodeId n) const
+{
+  return m_spelling_strings.get(m_spellings[n]);
+}
+
+/**
+ * \brief returns the USR of a node
+ *
+ * USRs are only saved for declarations, this returns an empty string for
+ * other nodes.
+ */
+inline StringView SnapshotFile::usr(NodeId n) const
+{
+  return m_usr_strings.get(m_usrs[n]);
+}
+
+/**
+ * \brief returns the number of files
+ */
+inline size_t SnapshotFile::fileCount() const
+{
+  return m_header ? m_header->file_count : 0;
+}
+
+/**
+ * \brief returns the name of a file
+ */
+inline StringView SnapshotFile::fileName(uint32_t id) const
+{
+  return m_file_name_strings.get(m_files[id].name);
+}
+
+/**
+ * \brief returns the size in bytes of a file
+ */
+inline size_t SnapshotFile::fileSize(uint32_t id) const
+{
+  return static_cast<size_t>(m_files[id].size);
+}
+
+/**
+ * \brief returns the include depth of a file
+ */
+inline unsigned SnapshotFile::depth(uint32_t id) const
+{
+  return m_files[id].depth;
+}
+
+} // namespace libclang
+
+#endif // LIBCLANGUTILS_SNAPSHOTFILE_H
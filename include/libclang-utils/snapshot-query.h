@@ -0,0 +1,144 @@
+// Copyright (C) 2023 Vincent Chambrin
+// This file is part of the 'libclang-utils' project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#ifndef LIBCLANGUTILS_SNAPSHOTQUERY_H
+#define LIBCLANGUTILS_SNAPSHOTQUERY_H
+
+#include "libclang-utils/ast-snapshot.h"
+#include "libclang-utils/thread-pool.h"
+
+#include <vector>
+
+namespace libclang
+{
+
+/**
+ * \brief runs queries over a snapshot using a thread pool
+ *
+ * A snapshot is immutable once built, so it can be read from several
+ * threads at once, unlike the translation unit it was built from.
+ * The work is partitioned by top-level declaration (i.e. children of the
+ * root): each partition is processed by a single task and the partial
+ * results are merged in partition order, so that results do not depend
+ * on scheduling.
+ *
+ * Functions passed to the queries receive the snapshot and a node id;
+ * they must only read the arrays of the snapshot and not call libclang
+ * (in particular, not use AstSnapshot::cursor()).
+ */
+class SnapshotQuery
+{
+public:
+  typedef AstSnapshot::NodeId NodeId;
+
+private:
+  ThreadPool& m_pool;
+  const AstSnapshot& m_snapshot;
+
+public:
+  SnapshotQuery(ThreadPool& pool, const AstSnapshot& snapshot);
+
+  const AstSnapshot& snapshot() const;
+
+  template<typename Pred>
+  std::vector<NodeId> findAll(Pred&& pred) const;
+
+  template<typename Pred>
+  size_t count(Pred&& pred) const;
+
+  template<typename T, typename Accumulate, typename Combine>
+  T reduce(T init, Accumulate&& accumulate, Combine&& combine) const;
+};
+
+inline SnapshotQuery::SnapshotQuery(ThreadPool& pool, const AstSnapshot& snapshot)
+  : m_pool(pool), m_snapshot(snapshot)
+{
+
+}
+
+/**
+ * \brief returns the snapshot the queries run on
+ */
+inline const AstSnapshot& SnapshotQuery::snapshot() const
+{
+  return m_snapshot;
+}
+
+/**
+ * \brief reduces all the nodes of the snapshot to a single value
+ * \param init        the initial value of each partition and of the result
+ * \param accumulate  a function called as accumulate(T&, const AstSnapshot&, NodeId) for each node
+ * \param combine     a function called as combine(T&, T&&) to merge a partition into the result
+ *
+ * Nodes are accumulated in pre-order within a partition, and partitions are
+ * combined in the order of the top-level declarations, the root being
+ * accumulated first.
+ */
+template<typename T, typename Accumulate, typename Combine>
+inline T SnapshotQuery::reduce(T init, Accumulate&& accumulate, Combine&& combine) const
+{
+  T result = init;
+
+  if (m_snapshot.empty())
+    return result;
+
+  const NodeId root = m_snapshot.root();
+  const size_t nb_partitions = m_snapshot.childCount(root);
+  std::vector<T> partials(nb_partitions, init);
+
+  accumulate(result, m_snapshot, root);
+
+  m_pool.parallelFor(nb_partitions, [&](size_t i) {
+    NodeId first = m_snapshot.childAt(root, i);
+    NodeId last = m_snapshot.subtreeEnd(first);
+
+    for (NodeId n = first; n < last; ++n)
+      accumulate(partials[i], m_snapshot, n);
+    });
+
+  for (T& p : partials)
+    combine(result, std::move(p));
+
+  return result;
+}
+
+/**
+ * \brief returns the nodes satisfying a predicate
+ * \param pred  a function called as pred(const AstSnapshot&, NodeId)
+ *
+ * The nodes are returned in increasing order.
+ */
+template<typename Pred>
+inline std::vector<SnapshotQuery::NodeId> SnapshotQuery::findAll(Pred&& pred) const
+{
+  return reduce(std::vector<NodeId>(),
+    [&pred](std::vector<NodeId>& acc, const AstSnapshot& s, NodeId n) {
+      if (pred(s, n))
+        acc.push_back(n);
+    },
+    [](std::vector<NodeId>& result, std::vector<NodeId>&& partial) {
+      result.insert(result.end(), partial.begin(), partial.end());
+    });
+}
+
+/**
+ * \brief returns the number of nodes satisfying a predicate
+ * \param pred  a function called as pred(const AstSnapshot&, NodeId)
+ */
+template<typename Pred>
+inline size_t SnapshotQuery::count(Pred&& pred) const
+{
+  return reduce(size_t(0),
+    [&pred](size_t& acc, const AstSnapshot& s, NodeId n) {
+      if (pred(s, n))
+        ++acc;
+    },
+    [](size_t& result, size_t&& partial) {
+      result += partial;
+    });
+}
+
+} // namespace libclang
+
+#endif // LIBCLANGUTILS_SNAPSHOTQUERY_H
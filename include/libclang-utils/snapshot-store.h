@@ -0,0 +1,175 @@
+// Copyright (C) 2023 Vincent Chambrin
+// This file is part of the 'libclang-utils' project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#ifndef LIBCLANGUTILS_SNAPSHOTSTORE_H
+#define LIBCLANGUTILS_SNAPSHOTSTORE_H
+
+#include "libclang-utils/ast-snapshot.h"
+#include "libclang-utils/file-table.h"
+#include "libclang-utils/string-table.h"
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace libclang
+{
+
+/**
+ * \brief a piece of AST shared between translation units
+ *
+ * A fragment contains consecutive top-level declarations of a translation
+ * unit that come from the same file, together with all their descendants.
+ * Nodes are numbered in pre-order from 0 and parents are fragment-local
+ * (NoNode for the top-level declarations).
+ *
+ * Fragments do not refer to libclang objects.
+ */
+struct SnapshotFragment
+{
+  CXFileUniqueID unique_id;
+  StringTable::Id file_name;
+  uint64_t content_hash;
+  uint64_t structural_hash;
+  uint32_t references;
+
+  std::vector<CXCursorKind> kinds;
+  std::vector<AstSnapshot::NodeId> parents;
+  std::vector<unsigned> begin_offsets;
+  std::vector<unsigned> end_offsets;
+  std::vector<StringTable::Id> spellings;
+
+  size_t size() const { return kinds.size(); }
+};
+
+/**
+ * \brief stores the snapshots of many translation units, sharing identical parts
+ *
+ * Each snapshot added to the store is split into fragments (see
+ * SnapshotFragment).
+ * A fragment is identified by the unique id and the content hash of its
+ * file and by its structural hash: headers included by several
+ * translation units, and parsed identically by each of them, are stored
+ * once and referenced from every translation unit.
+ */
+class LIBCLANGU_API SnapshotStore
+{
+public:
+  typedef uint32_t FragmentId;
+  typedef uint32_t UnitId;
+
+  struct Unit
+  {
+    StringTable::Id name;
+    std::vector<FragmentId> fragments;
+  };
+
+private:
+  struct FragmentKey
+  {
+    CXFileUniqueID unique_id;
+    uint64_t content_hash;
+    uint64_t structural_hash;
+    size_t size;
+  };
+
+  struct FragmentKeyHash
+  {
+    size_t operator()(const FragmentKey& key) const noexcept;
+  };
+
+  struct FragmentKeyEqual
+  {
+    bool operator()(const FragmentKey& lhs, const FragmentKey& rhs) const noexcept;
+  };
+
+  StringTable m_strings;
+  std::vector<SnapshotFragment> m_fragments;
+  std::vector<Unit> m_units;
+  std::unordered_map<FragmentKey, FragmentId, FragmentKeyHash, FragmentKeyEqual> m_index;
+  size_t m_referenced_nodes = 0;
+  size_t m_stored_nodes = 0;
+
+public:
+  SnapshotStore() = default;
+  SnapshotStore(const SnapshotStore&) = delete;
+  SnapshotStore(SnapshotStore&&) = default;
+  ~SnapshotStore() = default;
+
+  UnitId add(const AstSnapshot& snapshot);
+
+  size_t unitCount() const;
+  const Unit& unit(UnitId id) const;
+
+  size_t fragmentCount() const;
+  const SnapshotFragment& fragment(FragmentId id) const;
+
+  StringView string(StringTable::Id id) const;
+
+  size_t storedNodeCount() const;
+  size_t referencedNodeCount() const;
+
+  SnapshotStore& operator=(const SnapshotStore&) = delete;
+  SnapshotStore& operator=(SnapshotStore&&) = default;
+};
+
+/**
+ * \brief returns the number of translation units in the store
+ */
+inline size_t SnapshotStore::unitCount() const
+{
+  return m_units.size();
+}
+
+/**
+ * \brief returns a translation unit of the store
+ */
+inline const SnapshotStore::Unit& SnapshotStore::unit(UnitId id) const
+{
+  return m_units.at(id);
+}
+
+/**
+ * \brief returns the number of distinct fragments in the store
+ */
+inline size_t SnapshotStore::fragmentCount() const
+{
+  return m_fragments.size();
+}
+
+/**
+ * \brief returns a fragment of the store
+ */
+inline const SnapshotFragment& SnapshotStore::fragment(FragmentId id) const
+{
+  return m_fragments.at(id);
+}
+
+/**
+ * \brief returns a string (file name or spelling) of the store
+ */
+inline StringView SnapshotStore::string(StringTable::Id id) const
+{
+  return m_strings.get(id);
+}
+
+/**
+ * \brief returns the number of nodes actually stored
+ */
+inline size_t SnapshotStore::storedNodeCount() const
+{
+  return m_stored_nodes;
+}
+
+/**
+ * \brief returns the number of nodes of all the translation units, without deduplication
+ */
+inline size_t SnapshotStore::referencedNodeCount() const
+{
+  return m_referenced_nodes;
+}
+
+} // namespace libclang
+
+#endif // LIBCLANGUTILS_SNAPSHOTSTORE_H
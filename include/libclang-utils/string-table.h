@@ -0,0 +1,90 @@
+// Copyright (C) 2023 Vincent Chambrin
+// This file is part of the 'libclang-utils' project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#ifndef LIBCLANGUTILS_STRING_TABLE_H
+#define LIBCLANGUTILS_STRING_TABLE_H
+
+#include "libclang-utils/libclang-utils-defs.h"
+#include "libclang-utils/string-view.h"
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace libclang
+{
+
+/**
+ * \brief a table of interned strings
+ *
+ * Each distinct string is stored once and identified by a dense integer id.
+ * Characters are stored in large chunks that are never reallocated, so views
+ * returned by get() stay valid for the lifetime of the table.
+ * Stored strings are null-terminated.
+ *
+ * The id 0 always refers to the empty string.
+ */
+class LIBCLANGU_API StringTable
+{
+public:
+  typedef uint32_t Id;
+
+private:
+  std::vector<std::unique_ptr<char[]>> m_chunks;
+  size_t m_chunk_used = 0;
+  size_t m_chunk_capacity = 0;
+  std::vector<StringView> m_strings;
+  std::unordered_map<StringView, Id> m_ids;
+
+public:
+  StringTable();
+  StringTable(const StringTable&) = delete;
+  StringTable(StringTable&&) = default;
+  ~StringTable() = default;
+
+  Id intern(StringView str);
+  Id find(StringView str) const;
+
+  StringView get(Id id) const;
+  const char* c_str(Id id) const;
+
+  size_t size() const;
+
+  StringTable& operator=(const StringTable&) = delete;
+  StringTable& operator=(StringTable&&) = default;
+
+protected:
+  const char* store(StringView str);
+};
+
+/**
+ * \brief returns the string associated with an id
+ */
+inline StringView StringTable::get(Id id) const
+{
+  return m_strings[id];
+}
+
+/**
+ * \brief returns the null-terminated string associated with an id
+ */
+inline const char* StringTable::c_str(Id id) const
+{
+  return m_strings[id].data();
+}
+
+/**
+ * \brief returns the number of strings in the table
+ *
+ * This includes the empty string.
+ */
+inline size_t StringTable::size() const
+{
+  return m_strings.size();
+}
+
+} // namespace libclang
+
+#endif // LIBCLANGUTILS_STRING_TABLE_H
@@ -0,0 +1,173 @@
+// Copyright (C) 2023 Vincent Chambrin
+// This file is part of the 'libclang-utils' project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#ifndef LIBCLANGUTILS_STRING_VIEW_H
+#define LIBCLANGUTILS_STRING_VIEW_H
+
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <string>
+
+namespace libclang
+{
+
+/**
+ * \brief a non-owning view over a sequence of characters
+ *
+ * This is a minimal replacement for std::string_view, which is not
+ * available in C++14.
+ */
+class StringView
+{
+private:
+  const char* m_data = nullptr;
+  size_t m_size = 0;
+
+public:
+  StringView() = default;
+  StringView(const StringView&) = default;
+  ~StringView() = default;
+
+  StringView(const char* str);
+  StringView(const char* str, size_t size);
+  StringView(const std::string& str);
+
+  const char* data() const;
+  size_t size() const;
+  bool empty() const;
+
+  const char* begin() const;
+  const char* end() const;
+
+  char operator[](size_t i) const;
+
+  StringView substr(size_t pos, size_t count) const;
+
+  std::string toStdString() const;
+
+  StringView& operator=(const StringView&) = default;
+};
+
+/**
+ * \brief constructs a view over a null-terminated string
+ */
+inline StringView::StringView(const char* str)
+  : m_data(str), m_size(str ? std::strlen(str) : 0)
+{
+
+}
+
+/**
+ * \brief constructs a view over the first \a size characters of \a str
+ */
+inline StringView::StringView(const char* str, size_t size)
+  : m_data(str), m_size(size)
+{
+
+}
+
+/**
+ * \brief constructs a view over a std::string
+ */
+inline StringView::StringView(const std::string& str)
+  : m_data(str.data()), m_size(str.size())
+{
+
+}
+
+inline const char* StringView::data() const
+{
+  return m_data;
+}
+
+inline size_t StringView::size() const
+{
+  return m_size;
+}
+
+inline bool StringView::empty() const
+{
+  return m_size == 0;
+}
+
+inline const char* StringView::begin() const
+{
+  return m_data;
+}
+
+inline const char* StringView::end() const
+{
+  return m_data + m_size;
+}
+
+inline char StringView::operator[](size_t i) const
+{
+  return m_data[i];
+}
+
+/**
+ * \brief returns a view over a part of this view
+ *
+ * The range is clamped to the size of the view.
+ */
+inline StringView StringView::substr(size_t pos, size_t count) const
+{
+  if (pos > m_size)
+    pos = m_size;
+
+  if (count > m_size - pos)
+    count = m_size - pos;
+
+  return StringView(m_data + pos, count);
+}
+
+/**
+ * \brief returns a copy of the characters as a std::string
+ */
+inline std::string StringView::toStdString() const
+{
+  return std::string(m_data, m_size);
+}
+
+inline bool operator==(const StringView& lhs, const StringView& rhs)
+{
+  return lhs.size() == rhs.size() && (lhs.size() == 0 || std::memcmp(lhs.data(), rhs.data(), lhs.size()) == 0);
+}
+
+inline bool operator!=(const StringView& lhs, const StringView& rhs)
+{
+  return !(lhs == rhs);
+}
+
+inline bool operator<(const StringView& lhs, const StringView& rhs)
+{
+  size_t n = lhs.size() < rhs.size() ? lhs.size() : rhs.size();
+  int c = n > 0 ? std::memcmp(lhs.data(), rhs.data(), n) : 0;
+  return c < 0 || (c == 0 && lhs.size() < rhs.size());
+}
+
+} // namespace libclang
+
+namespace std
+{
+template<> struct hash<libclang::StringView>
+{
+  std::size_t operator()(const libclang::StringView& str) const noexcept
+  {
+    // FNV-1a
+    std::size_t h = static_cast<std::size_t>(14695981039346656037ULL);
+
+    for (char c : str)
+    {
+      h ^= static_cast<unsigned char>(c);
+      h *= static_cast<std::size_t>(1099511628211ULL);
+    }
+
+    return h;
+  }
+};
+}
+
+#endif // LIBCLANGUTILS_STRING_VIEW_H
@@ -0,0 +1,101 @@
+// Copyright (C) 2023 Vincent Chambrin
+// This file is part of the 'libclang-utils' project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#ifndef LIBCLANGUTILS_SYMBOLADJACENCY_H
+#define LIBCLANGUTILS_SYMBOLADJACENCY_H
+
+#include "libclang-utils/array-view.h"
+#include "libclang-utils/symbol-key.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace libclang
+{
+
+/**
+ * \brief a directed edge between two symbols
+ */
+struct SymbolEdge
+{
+  SymbolKey from;
+  SymbolKey to;
+};
+
+inline bool operator==(const SymbolEdge& lhs, const SymbolEdge& rhs)
+{
+  return lhs.from == rhs.from && lhs.to == rhs.to;
+}
+
+inline bool operator<(const SymbolEdge& lhs, const SymbolEdge& rhs)
+{
+  return lhs.from < rhs.from || (lhs.from == rhs.from && lhs.to < rhs.to);
+}
+
+/**
+ * \brief adjacency lists of symbols in compressed sparse row form
+ *
+ * The source symbols are stored in a sorted array and the targets of the
+ * i-th source are the elements [offsets[i], offsets[i + 1]) of a single
+ * array of targets, so looking up the targets of a symbol is a binary
+ * search followed by a contiguous read.
+ */
+class LIBCLANGU_API SymbolAdjacency
+{
+private:
+  std::vector<SymbolKey> m_sources;
+  std::vector<uint32_t> m_offsets;
+  std::vector<SymbolKey> m_targets;
+
+public:
+  SymbolAdjacency();
+  SymbolAdjacency(const SymbolAdjacency&) = default;
+  SymbolAdjacency(SymbolAdjacency&&) = default;
+  ~SymbolAdjacency() = default;
+
+  explicit SymbolAdjacency(const std::vector<SymbolEdge>& sorted_edges);
+
+  size_t sourceCount() const;
+  size_t edgeCount() const;
+
+  ArrayView<SymbolKey> sources() const;
+  ArrayView<SymbolKey> targets(SymbolKey from) const;
+
+  SymbolAdjacency& operator=(const SymbolAdjacency&) = default;
+  SymbolAdjacency& operator=(SymbolAdjacency&&) = default;
+};
+
+/**
+ * \brief returns the number of symbols that have at least one target
+ */
+inline size_t SymbolAdjacency::sourceCount() const
+{
+  return m_sources.size();
+}
+
+/**
+ * \brief returns the number of edges
+ */
+inline size_t SymbolAdjacency::edgeCount() const
+{
+  return m_targets.size();
+}
+
+/**
+ * \brief returns the sorted list of the symbols that have at least one target
+ */
+inline ArrayView<SymbolKey> SymbolAdjacency::sources() const
+{
+  return ArrayView<SymbolKey>(m_sources);
+}
+
+namespace details
+{
+LIBCLANGU_API void sort_edges(std::vector<SymbolEdge>& edges);
+LIBCLANGU_API std::vector<SymbolEdge> reverse_edges(const std::vector<SymbolEdge>& edges);
+} // namespace details
+
+} // namespace libclang
+
+#endif // LIBCLANGUTILS_SYMBOLADJACENCY_H
@@ -0,0 +1,117 @@
+// Copyright (C) 2023 Vincent Chambrin
+// This file is part of the 'libclang-utils' project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#ifndef LIBCLANGUTILS_SYMBOLKEY_H
+#define LIBCLANGUTILS_SYMBOLKEY_H
+
+#include "libclang-utils/clang-cursor.h"
+#include "libclang-utils/string-table.h"
+
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+
+namespace libclang
+{
+
+/**
+ * \brief identifies a symbol by a 64-bit hash of its USR
+ *
+ * Keys are compared and hashed as integers, which makes them much cheaper
+ * to use in hash maps than USR strings.
+ * A null key (hash 0) is used for cursors that have no USR.
+ *
+ * Keys computed with symbolKey() may in theory collide; keys produced by
+ * a SymbolKeyTable are guaranteed to be distinct for distinct USRs within
+ * that table, which also keeps the USR of each key.
+ */
+struct SymbolKey
+{
+  uint64_t hash = 0;
+
+  bool isNull() const { return hash == 0; }
+};
+
+inline bool operator==(const SymbolKey& lhs, const SymbolKey& rhs)
+{
+  return lhs.hash == rhs.hash;
+}
+
+inline bool operator!=(const SymbolKey& lhs, const SymbolKey& rhs)
+{
+  return lhs.hash != rhs.hash;
+}
+
+inline bool operator<(const SymbolKey& lhs, const SymbolKey& rhs)
+{
+  return lhs.hash < rhs.hash;
+}
+
+LIBCLANGU_API SymbolKey symbolKey(StringView usr, uint64_t seed = 0);
+LIBCLANGU_API SymbolKey symbolKey(const Cursor& c);
+
+/**
+ * \brief produces collision-free symbol keys
+ *
+ * The table interns the USR of each key it produces.
+ * If two different USRs hash to the same value, the second one is
+ * rehashed with another seed until a free key is found, so that every
+ * USR gets a distinct key.
+ */
+class LIBCLANGU_API SymbolKeyTable
+{
+private:
+  StringTable m_usrs;
+  std::unordered_map<uint64_t, StringTable::Id> m_keys;
+  size_t m_collisions = 0;
+
+public:
+  SymbolKeyTable() = default;
+  SymbolKeyTable(const SymbolKeyTable&) = delete;
+  SymbolKeyTable(SymbolKeyTable&&) = default;
+  ~SymbolKeyTable() = default;
+
+  SymbolKey insert(StringView usr);
+  SymbolKey insert(const Cursor& c);
+  SymbolKey find(StringView usr) const;
+
+  StringView usr(SymbolKey key) const;
+
+  size_t size() const;
+  size_t collisions() const;
+
+  SymbolKeyTable& operator=(const SymbolKeyTable&) = delete;
+  SymbolKeyTable& operator=(SymbolKeyTable&&) = default;
+};
+
+/**
+ * \brief returns the number of keys in the table
+ */
+inline size_t SymbolKeyTable::size() const
+{
+  return m_keys.size();
+}
+
+/**
+ * \brief returns the number of hash collisions that were resolved by the table
+ */
+inline size_t SymbolKeyTable::collisions() const
+{
+  return m_collisions;
+}
+
+} // namespace libclang
+
+namespace std
+{
+template<> struct hash<libclang::SymbolKey>
+{
+  std::size_t operator()(const libclang::SymbolKey& key) const noexcept
+  {
+    return static_cast<std::size_t>(key.hash);
+  }
+};
+}
+
+#endif // LIBCLANGUTILS_SYMBOLKEY_H
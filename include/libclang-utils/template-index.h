@@ -0,0 +1,182 @@
+// Copyright (C) 2023 Vincent Chambrin
+// This file is part of the 'libclang-utils' project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#ifndef LIBCLANGUTILS_TEMPLATEINDEX_H
+#define LIBCLANGUTILS_TEMPLATEINDEX_H
+
+#include "libclang-utils/string-table.h"
+#include "libclang-utils/symbol-adjacency.h"
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace libclang
+{
+
+class TranslationUnit;
+
+/**
+ * \brief a template argument of an instantiation
+ *
+ * The type is set for type arguments and the value for integral
+ * arguments; other kinds of arguments only have their kind recorded.
+ */
+struct TemplateArgument
+{
+  CXTemplateArgumentKind kind;
+  StringTable::Id type;
+  long long value;
+};
+
+/**
+ * \brief an instantiation of a template
+ *
+ * The template may be a primary template, a partial specialization or,
+ * for members of class templates, the member the instantiation was
+ * instantiated from.
+ */
+struct TemplateInstantiation
+{
+  SymbolKey specialization;
+  SymbolKey primary;
+  uint32_t first_argument;
+  uint32_t argument_count;
+  uint32_t unit_count; // number of translation units using the instantiation
+};
+
+/**
+ * \brief an index of the specializations and instantiations of templates
+ *
+ * Explicit and partial specializations are the specializations declared
+ * in the source; they are mapped to their template.
+ * Explicit instantiations of class templates (template struct Box<int>;
+ * and extern template struct Box<int>;) are recorded separately; an
+ * explicit instantiation definition also counts as an instantiation.
+ *
+ * Instantiations are found through the types of declarations and
+ * expressions and through the declarations referenced by expressions
+ * (e.g. calls to function templates). Each instantiation is recorded once
+ * per translation unit, with its template arguments.
+ * When indexes of several translation units are merged, the unit count
+ * of an instantiation tells in how many translation units it was used,
+ * i.e. how many times it was instantiated.
+ *
+ * Templates and specializations are identified by the SymbolKey of their USR.
+ */
+class LIBCLANGU_API TemplateIndex
+{
+private:
+  size_t m_unit_count = 0;
+  std::vector<SymbolEdge> m_explicit;
+  std::vector<SymbolEdge> m_partial;
+  std::vector<SymbolEdge> m_explicit_instantiations;
+  std::vector<TemplateInstantiation> m_instantiations;
+  std::vector<TemplateArgument> m_arguments;
+  std::unordered_map<SymbolKey, uint32_t> m_rows;
+  StringTable m_strings;
+  SymbolAdjacency m_explicit_specializations;
+  SymbolAdjacency m_partial_specializations;
+  SymbolAdjacency m_explicit_instantiations_by_template;
+  SymbolAdjacency m_instantiations_by_template;
+
+public:
+  TemplateIndex() = default;
+  TemplateIndex(const TemplateIndex&) = delete;
+  TemplateIndex(TemplateIndex&&) = default;
+  ~TemplateIndex() = default;
+
+  explicit TemplateIndex(const TranslationUnit& tu);
+
+  size_t unitCount() const;
+
+  ArrayView<SymbolKey> explicitSpecializations(SymbolKey primary) const;
+  ArrayView<SymbolKey> partialSpecializations(SymbolKey primary) const;
+  ArrayView<SymbolKey> explicitInstantiations(SymbolKey primary) const;
+
+  const std::vector<TemplateInstantiation>& instantiations() const;
+  const TemplateInstantiation* findInstantiation(SymbolKey specialization) const;
+  ArrayView<SymbolKey> instantiationsOf(SymbolKey primary) const;
+  ArrayView<TemplateArgument> arguments(const TemplateInstantiation& inst) const;
+  StringView string(StringTable::Id id) const;
+
+  std::vector<const TemplateInstantiation*> duplicatedInstantiations(uint32_t min_units = 2) const;
+
+  void merge(const TemplateIndex& other);
+  void merge(const std::vector<const TemplateIndex*>& others);
+
+  TemplateIndex& operator=(const TemplateIndex&) = delete;
+  TemplateIndex& operator=(TemplateIndex&&) = default;
+
+protected:
+  void build();
+};
+
+/**
+ * \brief returns the number of translation units in the index
+ */
+inline size_t TemplateIndex::unitCount() const
+{
+  return m_unit_count;
+}
+
+/**
+ * \brief returns the explicit (full) specializations of a template
+ */
+inline ArrayView<SymbolKey> TemplateIndex::explicitSpecializations(SymbolKey primary) const
+{
+  return m_explicit_specializations.targets(primary);
+}
+
+/**
+ * \brief returns the partial specializations of a class template
+ */
+inline ArrayView<SymbolKey> TemplateIndex::partialSpecializations(SymbolKey primary) const
+{
+  return m_partial_specializations.targets(primary);
+}
+
+/**
+ * \brief returns the explicit instantiations of a class template
+ */
+inline ArrayView<SymbolKey> TemplateIndex::explicitInstantiations(SymbolKey primary) const
+{
+  return m_explicit_instantiations_by_template.targets(primary);
+}
+
+/**
+ * \brief returns all the instantiations
+ */
+inline const std::vector<TemplateInstantiation>& TemplateIndex::instantiations() const
+{
+  return m_instantiations;
+}
+
+/**
+ * \brief returns the instantiations of a template
+ */
+inline ArrayView<SymbolKey> TemplateIndex::instantiationsOf(SymbolKey primary) const
+{
+  return m_instantiations_by_template.targets(primary);
+}
+
+/**
+ * \brief returns the template arguments of an instantiation
+ */
+inline ArrayView<TemplateArgument> TemplateIndex::arguments(const TemplateInstantiation& inst) const
+{
+  return ArrayView<TemplateArgument>(m_arguments.data() + inst.first_argument, inst.argument_count);
+}
+
+/**
+ * \brief returns a string of the index (e.g. the type of a template argument)
+ */
+inline StringView TemplateIndex::string(StringTable::Id id) const
+{
+  return m_strings.get(id);
+}
+
+} // namespace libclang
+
+#endif // LIBCLANGUTILS_TEMPLATEINDEX_H
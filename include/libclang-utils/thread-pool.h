@@ -0,0 +1,142 @@
+// Copyright (C) 2023 Vincent Chambrin
+// This file is part of the 'libclang-utils' project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#ifndef LIBCLANGUTILS_THREADPOOL_H
+#define LIBCLANGUTILS_THREADPOOL_H
+
+#include "libclang-utils/libclang-utils-defs.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace libclang
+{
+
+/**
+ * \brief a work-stealing thread pool
+ *
+ * Each worker has its own task queue; tasks are distributed over the
+ * queues in a round-robin fashion and a worker whose queue is empty
+ * steals tasks from the other queues.
+ *
+ * parallelFor() blocks until all its tasks are done, the calling thread
+ * executing pending tasks in the meantime, so it can safely be called
+ * from within a task.
+ */
+class LIBCLANGU_API ThreadPool
+{
+public:
+  typedef std::function<void()> Task;
+
+private:
+  struct Queue
+  {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+
+  std::vector<std::unique_ptr<Queue>> m_queues;
+  std::vector<std::thread> m_threads;
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  std::atomic<size_t> m_pending{ 0 };
+  std::atomic<size_t> m_next_queue{ 0 };
+  bool m_stop = false;
+
+public:
+  explicit ThreadPool(unsigned nb_threads = 0);
+  ThreadPool(const ThreadPool&) = delete;
+  ~ThreadPool();
+
+  size_t size() const;
+
+  void submit(Task task);
+
+  template<typename F>
+  void parallelFor(size_t count, F&& f);
+
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+protected:
+  bool runPendingTask(size_t self);
+  void work(size_t self);
+};
+
+/**
+ * \brief returns the number of worker threads
+ */
+inline size_t ThreadPool::size() const
+{
+  return m_threads.size();
+}
+
+/**
+ * \brief calls f(i) for each i in [0, count) using the threads of the pool
+ *
+ * The function returns once all calls are done.
+ * If a call throws, the first exception is rethrown after all calls are
+ * done.
+ */
+template<typename F>
+inline void ThreadPool::parallelFor(size_t count, F&& f)
+{
+  struct Batch
+  {
+    std::atomic<size_t> remaining;
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::exception_ptr error;
+  };
+
+  if (count == 0)
+    return;
+
+  auto batch = std::make_shared<Batch>();
+  batch->remaining = count;
+
+  for (size_t i(0); i < count; ++i)
+  {
+    submit([batch, &f, i]() {
+      try
+      {
+        f(i);
+      }
+      catch (...)
+      {
+        std::lock_guard<std::mutex> lock{ batch->mutex };
+        if (!batch->error)
+          batch->error = std::current_exception();
+      }
+
+      if (--batch->remaining == 0)
+      {
+        std::lock_guard<std::mutex> lock{ batch->mutex };
+        batch->cv.notify_all();
+      }
+      });
+  }
+
+  while (batch->remaining > 0)
+  {
+    if (!runPendingTask(m_queues.size()))
+    {
+      std::unique_lock<std::mutex> lock{ batch->mutex };
+      batch->cv.wait(lock, [&batch]() { return batch->remaining == 0; });
+    }
+  }
+
+  if (batch->error)
+    std::rethrow_exception(batch->error);
+}
+
+} // namespace libclang
+
+#endif // LIBCLANGUTILS_THREADPOOL_H
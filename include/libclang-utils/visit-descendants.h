@@ -0,0 +1,152 @@
+// Copyright (C) 2023 Vincent Chambrin
+// This file is part of the 'libclang-utils' project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#ifndef LIBCLANGUTILS_VISITDESCENDANTS_H
+#define LIBCLANGUTILS_VISITDESCENDANTS_H
+
+#include "libclang-utils/clang-cursor.h"
+
+#include <cstdint>
+#include <type_traits>
+
+namespace libclang
+{
+
+/**
+ * \brief a set of cursor kinds usable in constant expressions
+ *
+ * Kinds greater than or equal to MaxKind are never part of the set.
+ */
+struct CursorKindMask
+{
+  static constexpr int MaxKind = 1024;
+
+  uint64_t words[MaxKind / 64];
+
+  constexpr bool contains(int k) const
+  {
+    return k >= 0 && k < MaxKind && ((words[k >> 6] >> (k & 63)) & 1);
+  }
+};
+
+/**
+ * \brief options of visitDescendants()
+ *
+ * If \a skipFunctionBodies is true, the traversal doesn't enter the body
+ * of functions, methods and lambdas.
+ * Nothing declared or referenced in a body is visited, including local
+ * variables and local classes; other expressions, like the initializer
+ * of a global variable, are still visited.
+ */
+struct VisitDescendantsOptions
+{
+  bool skipFunctionBodies = false;
+};
+
+namespace details
+{
+
+template<CXCursorKind... Kinds>
+constexpr CursorKindMask make_kind_mask()
+{
+  CursorKindMask mask{};
+  const int kinds[] = { static_cast<int>(Kinds)... };
+
+  for (int k : kinds)
+  {
+    if (k >= 0 && k < CursorKindMask::MaxKind)
+      mask.words[k >> 6] |= uint64_t(1) << (k & 63);
+  }
+
+  return mask;
+}
+
+template<CXCursorKind... Kinds>
+struct KindFilter
+{
+  static constexpr CursorKindMask mask = make_kind_mask<Kinds...>();
+};
+
+template<CXCursorKind... Kinds>
+constexpr CursorKindMask KindFilter<Kinds...>::mask;
+
+// a compound statement (or function-try-block) directly under a
+// declaration or a lambda is the body of a function
+inline bool is_function_body(CXCursorKind k, CXCursorKind parent)
+{
+  if (k != CXCursor_CompoundStmt && k != CXCursor_CXXTryStmt)
+    return false;
+
+  return (parent >= CXCursor_FirstDecl && parent <= CXCursor_LastDecl) || parent == CXCursor_LambdaExpr;
+}
+
+template<typename F>
+struct KindFilteredVisitorData
+{
+  LibClang& libclang;
+  F& functor;
+  bool skip_function_bodies;
+};
+
+template<typename F>
+VisitResult invoke_kind_visitor(F& f, const Cursor& c, std::true_type)
+{
+  return f(c);
+}
+
+template<typename F>
+VisitResult invoke_kind_visitor(F& f, const Cursor& c, std::false_type)
+{
+  f(c);
+  return VisitResult::Recurse;
+}
+
+template<typename F, CXCursorKind... Kinds>
+CXChildVisitResult kind_filtered_visit_callback(CXCursor c, CXCursor parent, CXClientData client_data)
+{
+  auto& data = *static_cast<KindFilteredVisitorData<F>*>(client_data);
+
+  // kinds are read from the CXCursor, no call to libclang and no Cursor is needed
+  if (!KindFilter<Kinds...>::mask.contains(c.kind))
+    return (data.skip_function_bodies && is_function_body(c.kind, parent.kind)) ? CXChildVisit_Continue : CXChildVisit_Recurse;
+
+  using ReturnsVisitResult = std::is_same<decltype(data.functor(std::declval<const Cursor&>())), VisitResult>;
+  return static_cast<CXChildVisitResult>(invoke_kind_visitor(data.functor, Cursor{ data.libclang, c }, ReturnsVisitResult{}));
+}
+
+} // namespace details
+
+/**
+ * \brief visits the descendants of a cursor that have one of the given kinds
+ * \param root  the cursor whose descendants are visited
+ * \param f     a functor called as f(const Cursor&) for each matching cursor
+ * \param opts  options of the traversal
+ * \return true if the traversal was stopped by returning VisitResult::Break
+ *
+ * The set of kinds is turned into a compile-time bitmask, and cursors of
+ * other kinds are rejected in the libclang callback before any Cursor is
+ * constructed.
+ *
+ * The functor may return void, in which case the children of matching
+ * cursors are visited, or a VisitResult.
+ *
+ * \code
+ * visitDescendants<CXCursor_FunctionDecl, CXCursor_CXXMethod>(tu.getCursor(), [](const Cursor& c) {
+ *   std::cout << c.getSpelling() << std::endl;
+ * });
+ * \endcode
+ */
+template<CXCursorKind... Kinds, typename F>
+inline bool visitDescendants(const Cursor& root, F&& f, VisitDescendantsOptions opts = {})
+{
+  static_assert(sizeof...(Kinds) > 0, "at least one cursor kind must be specified");
+
+  using Functor = typename std::remove_reference<F>::type;
+  details::KindFilteredVisitorData<Functor> data{ *root.api, f, opts.skipFunctionBodies };
+  return root.api->clang_visitChildren(root, details::kind_filtered_visit_callback<Functor, Kinds...>, &data) != 0;
+}
+
+} // namespace libclang
+
+#endif // LIBCLANGUTILS_VISITDESCENDANTS_H
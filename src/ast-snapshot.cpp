@@ -0,0 +1,169 @@
+// Copyright (C) 2023 Vincent Chambrin
+// This file is part of the 'libclang-utils' project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include "libclang-utils/ast-snapshot.h"
+
+#include "libclang-utils/clang-translation-unit.h"
+
+namespace libclang
+{
+
+namespace
+{
+
+struct SnapshotBuilder
+{
+  LibClang& api;
+  AstSnapshot& snapshot;
+  std::vector<CXCursor> stack_cursors;
+  std::vector<AstSnapshot::NodeId> stack;
+  std::vector<AstSnapshot::NodeId> last_children;
+  CXFile last_file = nullptr;
+  FileTable::Id last_file_id = FileTable::NoFile;
+
+  SnapshotBuilder(LibClang& lib, AstSnapshot& s);
+
+  AstSnapshot::NodeId add(CXCursor c, AstSnapshot::NodeId parent);
+  void push(CXCursor c, AstSnapshot::NodeId n);
+  void pop();
+};
+
+SnapshotBuilder::SnapshotBuilder(LibClang& lib, AstSnapshot& s)
+  : api(lib), snapshot(s)
+{
+
+}
+
+AstSnapshot::NodeId SnapshotBuilder::add(CXCursor c, AstSnapshot::NodeId parent)
+{
+  auto id = static_cast<AstSnapshot::NodeId>(snapshot.size());
+
+  snapshot.kinds.push_back(api.clang_getCursorKind(c));
+  snapshot.parents.push_back(parent);
+  snapshot.first_children.push_back(AstSnapshot::NoNode);
+  snapshot.next_siblings.push_back(AstSnapshot::NoNode);
+  snapshot.subtree_ends.push_back(id + 1);
+  snapshot.cursors.push_back(c);
+  snapshot.child_indices.push_back(0);
+  last_children.push_back(AstSnapshot::NoNode);
+
+  CXSourceRange extent = api.clang_getCursorExtent(c);
+  CXFile file = nullptr;
+  unsigned begin = 0;
+  unsigned end = 0;
+  api.clang_getSpellingLocation(api.clang_getRangeStart(extent), &file, nullptr, nullptr, &begin);
+  api.clang_getSpellingLocation(api.clang_getRangeEnd(extent), nullptr, nullptr, nullptr, &end);
+
+  snapshot.begin_offsets.push_back(begin);
+  snapshot.end_offsets.push_back(end);
+
+  if (file != last_file)
+  {
+    last_file = file;
+    last_file_id = snapshot.file_table.find(file);
+  }
+
+  snapshot.file_ids.push_back(last_file_id);
+
+  if (parent != AstSnapshot::NoNode)
+  {
+    AstSnapshot::NodeId prev = last_children[parent];
+
+    if (prev == AstSnapshot::NoNode)
+    {
+      snapshot.first_children[parent] = id;
+    }
+    else
+    {
+      snapshot.next_siblings[prev] = id;
+      snapshot.child_indices[id] = snapshot.child_indices[prev] + 1;
+    }
+
+    last_children[parent] = id;
+  }
+
+  return id;
+}
+
+void SnapshotBuilder::push(CXCursor c, AstSnapshot::NodeId n)
+{
+  stack_cursors.push_back(c);
+  stack.push_back(n);
+}
+
+void SnapshotBuilder::pop()
+{
+  snapshot.subtree_ends[stack.back()] = static_cast<AstSnapshot::NodeId>(snapshot.size());
+  stack_cursors.pop_back();
+  stack.pop_back();
+}
+
+CXChildVisitResult snapshot_visitor(CXCursor c, CXCursor p, CXClientData client_data)
+{
+  auto& builder = *static_cast<SnapshotBuilder*>(client_data);
+
+  // leave the subtrees of the previously visited nodes
+  while (builder.stack.size() > 1 && !builder.api.clang_equalCursors(builder.stack_cursors.back(), p))
+    builder.pop();
+
+  AstSnapshot::NodeId n = builder.add(c, builder.stack.back());
+  builder.push(c, n);
+
+  return CXChildVisit_Recurse;
+}
+
+void build_snapshot(AstSnapshot& snapshot, const TranslationUnit& tu, CXCursor root)
+{
+  snapshot.api = tu.api;
+  snapshot.file_table = FileTable(tu);
+
+  SnapshotBuilder builder{ *tu.api, snapshot };
+  builder.push(root, builder.add(root, AstSnapshot::NoNode));
+  tu.api->clang_visitChildren(root, snapshot_visitor, &builder);
+
+  while (!builder.stack.empty())
+    builder.pop();
+
+  // lay out the children of each node contiguously
+  const size_t n = snapshot.size();
+  snapshot.child_offsets.assign(n + 1, 0);
+
+  for (size_t i(1); i < n; ++i)
+    ++snapshot.child_offsets[snapshot.parents[i] + 1];
+
+  for (size_t i(0); i < n; ++i)
+    snapshot.child_offsets[i + 1] += snapshot.child_offsets[i];
+
+  snapshot.children.resize(n > 0 ? n - 1 : 0);
+
+  for (size_t i(1); i < n; ++i)
+  {
+    AstSnapshot::NodeId p = snapshot.parents[i];
+    snapshot.children[snapshot.child_offsets[p] + snapshot.child_indices[i]] = static_cast<AstSnapshot::NodeId>(i);
+  }
+}
+
+} // namespace
+
+const AstSnapshot::NodeId AstSnapshot::NoNode;
+
+/**
+ * \brief builds a snapshot of the whole translation unit
+ *
+ * The root of the snapshot is the translation unit cursor.
+ */
+AstSnapshot::AstSnapshot(const TranslationUnit& tu)
+{
+  build_snapshot(*this, tu, tu.api->clang_getTranslationUnitCursor(tu));
+}
+
+/**
+ * \brief builds a snapshot of the subtree rooted at a cursor
+ */
+AstSnapshot::AstSnapshot(const TranslationUnit& tu, const Cursor& root)
+{
+  build_snapshot(*this, tu, root);
+}
+
+} // namespace libclang
@@ -0,0 +1,383 @@
+// Copyright (C) 2023 Vincent Chambrin
+// This file is part of the 'libclang-utils' project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include "libclang-utils/call-graph.h"
+
+#include "libclang-utils/clang-cursor.h"
+#include "libclang-utils/clang-translation-unit.h"
+#include "libclang-utils/thread-pool.h"
+
+#include <algorithm>
+#include <unordered_set>
+
+namespace libclang
+{
+
+namespace
+{
+
+bool is_function_kind(CXCursorKind k)
+{
+  switch (k)
+  {
+  case CXCursor_FunctionDecl:
+  case CXCursor_CXXMethod:
+  case CXCursor_Constructor:
+  case CXCursor_Destructor:
+  case CXCursor_ConversionFunction:
+  case CXCursor_FunctionTemplate:
+    return true;
+  default:
+    return false;
+  }
+}
+
+bool call_less(const CallEdge& lhs, const CallEdge& rhs)
+{
+  return lhs.caller < rhs.caller || (lhs.caller == rhs.caller && lhs.callee < rhs.callee);
+}
+
+bool same_call(const CallEdge& lhs, const CallEdge& rhs)
+{
+  return lhs.caller == rhs.caller && lhs.callee == rhs.callee;
+}
+
+CXChildVisitResult first_child_visitor(CXCursor c, CXCursor, CXClientData client_data)
+{
+  *static_cast<CXCursor*>(client_data) = c;
+  return CXChildVisit_Break;
+}
+
+void add_calls(LibClang& api, const Cursor& function, std::vector<CallEdge>& edges)
+{
+  SymbolKey caller = symbolKey(function);
+
+  if (caller.isNull())
+    return;
+
+  // the first child of each call expression, i.e. the expression naming the
+  // callee, identified by its Stmt (the parent declaration stored in the
+  // cursor differs when visiting from the call expression)
+  std::unordered_set<const void*> callee_exprs;
+
+  function.visitRecursively([&](const Cursor& c, const Cursor& parent) -> VisitResult {
+    CXCursorKind k = api.clang_getCursorKind(c);
+
+    if (k == CXCursor_CallExpr)
+    {
+      CXCursor first_child = api.clang_getNullCursor();
+      api.clang_visitChildren(c, first_child_visitor, &first_child);
+
+      if (!api.clang_Cursor_isNull(first_child))
+        callee_exprs.insert(first_child.data[1]);
+
+      SymbolKey callee = symbolKey(c.getReference());
+
+      if (!callee.isNull())
+      {
+        uint8_t flags = api.clang_Cursor_isDynamicCall(c) ? CallEdge::DynamicCall : CallEdge::DirectCall;
+        edges.push_back(CallEdge{ caller, callee, flags });
+      }
+    }
+    else if (k == CXCursor_OverloadedDeclRef && api.clang_isExpression(parent.kind()) && callee_exprs.count(parent.cursor.data[1]))
+    {
+      // an unresolved call, e.g. in a template; other overloaded references
+      // (using-declarations, overload sets passed as arguments) are not calls
+      unsigned n = api.clang_getNumOverloadedDecls(c);
+
+      for (unsigned i(0); i < n; ++i)
+      {
+        SymbolKey callee = symbolKey(Cursor(api, api.clang_getOverloadedDecl(c, i)));
+
+        if (!callee.isNull())
+          edges.push_back(CallEdge{ caller, callee, CallEdge::OverloadedCall });
+      }
+    }
+
+    return VisitResult::Recurse;
+    });
+}
+
+std::vector<CallEdge> extract_call_edges(const TranslationUnit& tu)
+{
+  LibClang& api = *tu.api;
+  std::vector<CallEdge> edges;
+
+  tu.getCursor().visitRecursively([&](const Cursor& c, const Cursor&) -> VisitResult {
+    CXCursorKind k = api.clang_getCursorKind(c);
+
+    if (!api.clang_isDeclaration(k))
+      return VisitResult::SkipSubtree;
+
+    if (is_function_kind(k))
+    {
+      if (api.clang_isCursorDefinition(c))
+        add_calls(api, c, edges);
+
+      return VisitResult::SkipSubtree;
+    }
+
+    return VisitResult::Recurse;
+    });
+
+  details::sort_call_edges(edges);
+  return edges;
+}
+
+} // namespace
+
+const CallGraph::NodeId CallGraph::NoNode;
+
+CallGraph::CallGraph()
+  : m_callee_offsets{ 0 },
+    m_caller_offsets{ 0 }
+{
+
+}
+
+/**
+ * \brief builds the call graph of a translation unit
+ *
+ * Callees are resolved with clang_getCursorReferenced(); calls that
+ * cannot be resolved (e.g. in templates) produce an edge flagged as
+ * OverloadedCall to each function of the overload set.
+ */
+CallGraph::CallGraph(const TranslationUnit& tu)
+  : m_edges(extract_call_edges(tu))
+{
+  build();
+}
+
+/**
+ * \brief builds a call graph from a list of edges
+ */
+CallGraph::CallGraph(std::vector<CallEdge> edges)
+  : m_edges(std::move(edges))
+{
+  details::sort_call_edges(m_edges);
+  build();
+}
+
+/**
+ * \brief returns the id of a function
+ * \return the id, or NoNode if the function is not in the graph
+ */
+CallGraph::NodeId CallGraph::find(SymbolKey function) const
+{
+  auto it = std::lower_bound(m_nodes.begin(), m_nodes.end(), function);
+  return (it != m_nodes.end() && *it == function) ? static_cast<NodeId>(std::distance(m_nodes.begin(), it)) : NoNode;
+}
+
+namespace
+{
+
+template<typename F>
+std::vector<CallGraph::NodeId> breadth_first(size_t nb_nodes, CallGraph::NodeId start, F&& next)
+{
+  std::vector<CallGraph::NodeId> result;
+  std::vector<bool> visited(nb_nodes, false);
+
+  auto visit = [&](CallGraph::NodeId n) {
+    for (CallGraph::NodeId m : next(n))
+    {
+      if (!visited[m])
+      {
+        visited[m] = true;
+        result.push_back(m);
+      }
+    }
+  };
+
+  visit(start);
+
+  for (size_t i(0); i < result.size(); ++i)
+    visit(result[i]);
+
+  return result;
+}
+
+} // namespace
+
+/**
+ * \brief returns the functions directly or indirectly called by a function
+ *
+ * The function itself is included only if it is part of a cycle.
+ */
+std::vector<CallGraph::NodeId> CallGraph::reachableFrom(NodeId n) const
+{
+  return breadth_first(nodeCount(), n, [this](NodeId m) { return callees(m); });
+}
+
+/**
+ * \brief returns the functions directly or indirectly calling a function
+ *
+ * These are the functions whose behavior may change if \a n changes.
+ */
+std::vector<CallGraph::NodeId> CallGraph::impactOf(NodeId n) const
+{
+  return breadth_first(nodeCount(), n, [this](NodeId m) { return callers(m); });
+}
+
+/**
+ * \brief adds the edges of another graph to this one
+ */
+void CallGraph::merge(const CallGraph& other)
+{
+  m_edges = details::merge_call_edges(m_edges, other.m_edges);
+  build();
+}
+
+void CallGraph::build()
+{
+  m_nodes.clear();
+  m_nodes.reserve(2 * m_edges.size());
+
+  for (const CallEdge& e : m_edges)
+  {
+    m_nodes.push_back(e.caller);
+    m_nodes.push_back(e.callee);
+  }
+
+  std::sort(m_nodes.begin(), m_nodes.end());
+  m_nodes.erase(std::unique(m_nodes.begin(), m_nodes.end()), m_nodes.end());
+
+  const size_t n = m_nodes.size();
+
+  m_callee_offsets.assign(n + 1, 0);
+  m_caller_offsets.assign(n + 1, 0);
+  m_callees.resize(m_edges.size());
+  m_flags.resize(m_edges.size());
+  m_callers.resize(m_edges.size());
+
+  std::vector<NodeId> callee_ids;
+  callee_ids.reserve(m_edges.size());
+
+  // edges are sorted by caller, so callees can be written in order
+  NodeId caller = 0;
+
+  for (size_t i(0); i < m_edges.size(); ++i)
+  {
+    const CallEdge& e = m_edges[i];
+
+    while (m_nodes[caller] != e.caller)
+      ++caller;
+
+    NodeId callee = find(e.callee);
+    callee_ids.push_back(callee);
+
+    m_callees[i] = callee;
+    m_flags[i] = e.flags;
+    ++m_callee_offsets[caller + 1];
+    ++m_caller_offsets[callee + 1];
+  }
+
+  for (size_t i(0); i < n; ++i)
+  {
+    m_callee_offsets[i + 1] += m_callee_offsets[i];
+    m_caller_offsets[i + 1] += m_caller_offsets[i];
+  }
+
+  // counting sort of the edges by callee
+  std::vector<uint32_t> positions(m_caller_offsets.begin(), m_caller_offsets.end() - 1);
+  caller = 0;
+
+  for (size_t i(0); i < m_edges.size(); ++i)
+  {
+    while (m_nodes[caller] != m_edges[i].caller)
+      ++caller;
+
+    m_callers[positions[callee_ids[i]]++] = caller;
+  }
+}
+
+/**
+ * \brief builds the call graph of several translation units in parallel
+ *
+ * The edges of each translation unit are extracted by a single thread;
+ * the sorted edge lists are then merged pairwise, also in parallel.
+ */
+CallGraph buildCallGraph(ThreadPool& pool, const std::vector<const TranslationUnit*>& units)
+{
+  std::vector<std::vector<CallEdge>> lists{ units.size() };
+
+  pool.parallelFor(units.size(), [&](size_t i) {
+    lists[i] = extract_call_edges(*units[i]);
+    });
+
+  while (lists.size() > 1)
+  {
+    std::vector<std::vector<CallEdge>> merged{ (lists.size() + 1) / 2 };
+
+    pool.parallelFor(lists.size() / 2, [&](size_t i) {
+      merged[i] = details::merge_call_edges(lists[2 * i], lists[2 * i + 1]);
+      });
+
+    if (lists.size() % 2 == 1)
+      merged.back() = std::move(lists.back());
+
+    std::swap(lists, merged);
+  }
+
+  return lists.empty() ? CallGraph() : CallGraph(std::move(lists.front()));
+}
+
+namespace details
+{
+
+/**
+ * \brief sorts a list of edges and merges the edges with the same caller and callee
+ */
+void sort_call_edges(std::vector<CallEdge>& edges)
+{
+  std::sort(edges.begin(), edges.end(), call_less);
+
+  size_t n = 0;
+
+  for (size_t i(0); i < edges.size(); ++i)
+  {
+    if (n > 0 && same_call(edges[n - 1], edges[i]))
+      edges[n - 1].flags |= edges[i].flags;
+    else
+      edges[n++] = edges[i];
+  }
+
+  edges.resize(n);
+}
+
+/**
+ * \brief merges two lists of edges sorted with sort_call_edges()
+ */
+std::vector<CallEdge> merge_call_edges(const std::vector<CallEdge>& a, const std::vector<CallEdge>& b)
+{
+  std::vector<CallEdge> result;
+  result.reserve(a.size() + b.size());
+
+  auto it = a.begin();
+  auto jt = b.begin();
+
+  while (it != a.end() && jt != b.end())
+  {
+    if (call_less(*it, *jt))
+    {
+      result.push_back(*it++);
+    }
+    else if (call_less(*jt, *it))
+    {
+      result.push_back(*jt++);
+    }
+    else
+    {
+      result.push_back(*it++);
+      result.back().flags |= (jt++)->flags;
+    }
+  }
+
+  result.insert(result.end(), it, a.end());
+  result.insert(result.end(), jt, b.end());
+  return result;
+}
+
+} // namespace details
+
+} // namespace libclang
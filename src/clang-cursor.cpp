@@ -5,6 +5,7 @@
 #include "libclang-utils/clang-cursor.h"
 
 #include "libclang-utils/clang-file.h"
+#include "libclang-utils/printing-policy.h"
 
 /*!
  * \namespace libclang
@@ -77,6 +78,42 @@ std::vector<Cursor> Cursor::children() const
   return result;
 }
 
+/**
+ * \brief prints the declaration of this cursor
+ * \param policy  the printing policy, see DeclarationPrinter
+ *
+ * Exposes clang_getCursorPrettyPrinted().
+ * The result is returned as a ClangString so that it can be read without
+ * being copied.
+ */
+ClangString Cursor::prettyPrinted(const PrintingPolicy& policy) const
+{
+  return ClangString(*api, api->clang_getCursorPrettyPrinted(this->cursor, policy));
+}
+
+/**
+ * \brief returns the methods directly overridden by this method
+ *
+ * Exposes clang_getOverriddenCursors().
+ */
+std::vector<Cursor> Cursor::getOverriddenCursors() const
+{
+  CXCursor* overridden = nullptr;
+  unsigned n = 0;
+  api->clang_getOverriddenCursors(this->cursor, &overridden, &n);
+
+  std::vector<Cursor> result;
+  result.reserve(n);
+
+  for (unsigned i(0); i < n; ++i)
+    result.push_back(Cursor(*api, overridden[i]));
+
+  if (overridden)
+    api->clang_disposeOverriddenCursors(overridden);
+
+  return result;
+}
+
 /**
  * \brief returns the index of a child
  * \param c  the child cursor
@@ -0,0 +1,273 @@
+// Copyright (C) 2023 Vincent Chambrin
+// This file is part of the 'libclang-utils' project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include "libclang-utils/clang-diagnostic.h"
+
+#include "libclang-utils/clang-translation-unit.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+namespace libclang
+{
+
+const uint32_t DiagnosticRecord::NoParent;
+
+static details::DiagnosticKey make_key(const DiagnosticRecord& d)
+{
+  details::DiagnosticKey key;
+  key.values[0] = static_cast<uint32_t>(d.severity);
+  key.values[1] = d.file;
+  key.values[2] = d.line;
+  key.values[3] = d.column;
+  key.values[4] = d.offset;
+  key.values[5] = d.message;
+  key.values[6] = d.option;
+  key.values[7] = d.parent;
+  return key;
+}
+
+static StringTable::Id intern(LibClang& api, StringTable& strings, CXString str)
+{
+  if (!str.data)
+    return 0;
+
+  StringTable::Id id = strings.intern(StringView(api.clang_getCString(str)));
+  api.clang_disposeString(str);
+  return id;
+}
+
+uint32_t DiagnosticList::insert(const DiagnosticRecord& record)
+{
+  details::DiagnosticKey key = make_key(record);
+  auto it = m_index.find(key);
+
+  if (it != m_index.end())
+  {
+    records[it->second].occurrences += record.occurrences;
+    return it->second;
+  }
+
+  uint32_t index = static_cast<uint32_t>(records.size());
+  records.push_back(record);
+  m_index[key] = index;
+  return index;
+}
+
+/**
+ * \brief adds a diagnostic and its child diagnostics to the list
+ * \param api         the libclang api
+ * \param diagnostic  the diagnostic
+ * \param parent      index of the parent diagnostic, if any
+ * \return the index of the diagnostic in the list
+ *
+ * The diagnostic is not disposed by this function.
+ */
+uint32_t DiagnosticList::add(LibClang& api, CXDiagnostic diagnostic, uint32_t parent)
+{
+  DiagnosticRecord record;
+  record.severity = api.clang_getDiagnosticSeverity(diagnostic);
+  record.category = api.clang_getDiagnosticCategory(diagnostic);
+
+  CXFile file = nullptr;
+  api.clang_getSpellingLocation(api.clang_getDiagnosticLocation(diagnostic), &file, &record.line, &record.column, &record.offset);
+  record.file = file ? intern(api, strings, api.clang_getFileName(file)) : 0;
+
+  record.message = intern(api, strings, api.clang_getDiagnosticSpelling(diagnostic));
+  record.option = intern(api, strings, api.clang_getDiagnosticOption(diagnostic, nullptr));
+  record.parent = parent;
+  record.occurrences = 1;
+
+  uint32_t index = insert(record);
+
+  CXDiagnosticSet children = api.clang_getChildDiagnostics(diagnostic);
+
+  if (children)
+  {
+    unsigned n = api.clang_getNumDiagnosticsInSet(children);
+
+    for (unsigned i(0); i < n; ++i)
+    {
+      CXDiagnostic child = api.clang_getDiagnosticInSet(children, i);
+      add(api, child, index);
+      api.clang_disposeDiagnostic(child);
+    }
+  }
+
+  return index;
+}
+
+/**
+ * \brief adds all the diagnostics of a set to the list
+ *
+ * The set is not disposed by this function.
+ */
+void DiagnosticList::addAll(LibClang& api, CXDiagnosticSet set)
+{
+  unsigned n = api.clang_getNumDiagnosticsInSet(set);
+
+  for (unsigned i(0); i < n; ++i)
+  {
+    CXDiagnostic d = api.clang_getDiagnosticInSet(set, i);
+    add(api, d);
+    api.clang_disposeDiagnostic(d);
+  }
+}
+
+/**
+ * \brief adds the diagnostics of another list to this list
+ *
+ * Diagnostics that are already present only have their occurrence
+ * count incremented.
+ */
+void DiagnosticList::merge(const DiagnosticList& other)
+{
+  std::vector<StringTable::Id> string_map;
+  string_map.reserve(other.strings.size());
+
+  for (size_t i(0); i < other.strings.size(); ++i)
+    string_map.push_back(strings.intern(other.strings.get(static_cast<StringTable::Id>(i))));
+
+  std::vector<uint32_t> record_map;
+  record_map.reserve(other.records.size());
+
+  for (DiagnosticRecord d : other.records)
+  {
+    d.file = string_map[d.file];
+    d.message = string_map[d.message];
+    d.option = string_map[d.option];
+
+    // parents always come before their children
+    if (d.parent != DiagnosticRecord::NoParent)
+      d.parent = record_map[d.parent];
+
+    record_map.push_back(insert(d));
+  }
+}
+
+/**
+ * \brief returns the diagnostics of a translation unit
+ */
+DiagnosticList getDiagnostics(const TranslationUnit& tu)
+{
+  LibClang& api = *tu.api;
+  DiagnosticList result;
+
+  unsigned n = api.clang_getNumDiagnostics(tu);
+
+  for (unsigned i(0); i < n; ++i)
+  {
+    CXDiagnostic d = api.clang_getDiagnostic(tu, i);
+    result.add(api, d);
+    api.clang_disposeDiagnostic(d);
+  }
+
+  return result;
+}
+
+/**
+ * \brief loads the diagnostics from a serialized diagnostics file
+ * \param api   the libclang api
+ * \param file  path of the file
+ *
+ * Serialized diagnostics files (.dia) are produced by clang with
+ * the \c --serialize-diagnostics option.
+ *
+ * Exposes clang_loadDiagnostics().
+ * Throws \t LibClangError if the file cannot be loaded.
+ */
+DiagnosticList loadDiagnostics(LibClang& api, const std::string& file)
+{
+  CXLoadDiag_Error error = CXLoadDiag_None;
+  CXString error_string = { nullptr, 0 };
+
+  CXDiagnosticSet set = api.clang_loadDiagnostics(file.c_str(), &error, &error_string);
+
+  if (!set)
+  {
+    std::string message = api.toStdString(error_string);
+    throw LibClangError{ ("could not load diagnostics from " + file + " : " + message).c_str() };
+  }
+
+  api.toStdString(error_string);
+
+  DiagnosticList result;
+  result.addAll(api, set);
+  api.clang_disposeDiagnosticSet(set);
+
+  return result;
+}
+
+/**
+ * \brief loads the diagnostics from several serialized diagnostics files in parallel
+ * \param api         the libclang api
+ * \param files       paths of the files
+ * \param errors      if not null, receives the error messages of the files that could not be loaded
+ * \param nb_threads  number of threads, or 0 to use the number of hardware threads
+ *
+ * Identical diagnostics reported in several files (e.g., a warning in a shared
+ * header) are stored once, with an occurrence count.
+ * The result does not depend on the number of threads: files are merged in
+ * the order in which they are provided.
+ *
+ * If \a errors is null, throws \t LibClangError if any of the files cannot be loaded.
+ */
+DiagnosticList loadDiagnostics(LibClang& api, const std::vector<std::string>& files, std::vector<std::string>* errors, unsigned nb_threads)
+{
+  if (nb_threads == 0)
+    nb_threads = std::max(1u, std::thread::hardware_concurrency());
+
+  nb_threads = static_cast<unsigned>(std::min<size_t>(nb_threads, files.size()));
+
+  std::vector<DiagnosticList> lists{ files.size() };
+  std::vector<std::string> messages{ files.size() };
+  std::atomic<size_t> next{ 0 };
+
+  auto work = [&]() {
+    for (size_t i = next++; i < files.size(); i = next++)
+    {
+      try
+      {
+        lists[i] = loadDiagnostics(api, files[i]);
+      }
+      catch (const LibClangError& err)
+      {
+        messages[i] = err.what();
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+
+  for (unsigned i(1); i < nb_threads; ++i)
+    threads.emplace_back(work);
+
+  work();
+
+  for (std::thread& t : threads)
+    t.join();
+
+  DiagnosticList result;
+
+  for (size_t i(0); i < files.size(); ++i)
+  {
+    if (!messages[i].empty())
+    {
+      if (!errors)
+        throw LibClangError{ messages[i].c_str() };
+
+      errors->push_back(std::move(messages[i]));
+    }
+    else
+    {
+      result.merge(lists[i]);
+      lists[i] = DiagnosticList();
+    }
+  }
+
+  return result;
+}
+
+} // namespace libclang
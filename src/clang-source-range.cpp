@@ -4,8 +4,78 @@
 
 #include "libclang-utils/clang-source-range.h"
 
+#include "libclang-utils/clang-translation-unit.h"
+
 namespace libclang
 {
 
-} // namespace libclang
+/**
+ * \brief returns the source text covered by the range
+ * \param tu  the translation unit the range belongs to
+ *
+ * The returned view points into the buffer of the file held by the
+ * translation unit (see TranslationUnit::getFileContents()), no string
+ * is allocated.
+ * It remains valid as long as the translation unit is neither disposed
+ * nor reparsed.
+ *
+ * An empty view is returned if the range is null or if its start and end
+ * are not in the same file.
+ */
+StringView SourceRange::text(const TranslationUnit& tu) const
+{
+  details::FileContentsCache cache;
+  return details::range_text(*api, tu, data, cache);
+}
+
+/**
+ * \brief returns the source text of several ranges
+ *
+ * The content of a file is fetched once for consecutive ranges of the
+ * same file. See SourceRange::text().
+ */
+std::vector<StringView> getTexts(const TranslationUnit& tu, const std::vector<SourceRange>& ranges)
+{
+  std::vector<StringView> result;
+  result.reserve(ranges.size());
+
+  details::FileContentsCache cache;
+
+  for (const SourceRange& r : ranges)
+    result.push_back(details::range_text(*tu.api, tu, r, cache));
+
+  return result;
+}
+
+namespace details
+{
 
+StringView range_text(LibClang& api, CXTranslationUnit tu, CXSourceRange range, FileContentsCache& cache)
+{
+  CXFile begin_file = nullptr;
+  CXFile end_file = nullptr;
+  unsigned begin = 0;
+  unsigned end = 0;
+
+  api.clang_getSpellingLocation(api.clang_getRangeStart(range), &begin_file, nullptr, nullptr, &begin);
+  api.clang_getSpellingLocation(api.clang_getRangeEnd(range), &end_file, nullptr, nullptr, &end);
+
+  if (!begin_file || !api.clang_File_isEqual(begin_file, end_file) || end < begin)
+    return StringView();
+
+  if (begin_file != cache.file)
+  {
+    cache.file = begin_file;
+    cache.size = 0;
+    cache.data = api.clang_getFileContents(tu, begin_file, &cache.size);
+  }
+
+  if (!cache.data || end > cache.size)
+    return StringView();
+
+  return StringView(cache.data + begin, end - begin);
+}
+
+} // namespace details
+
+} // namespace libclang
@@ -50,6 +50,20 @@ std::string Token::getSpelling() const
   return api->toStdString(str);
 }
 
+/**
+ * \brief returns the text of the token
+ *
+ * Unlike getSpelling(), this function does not allocate: the returned
+ * view points into the buffer of the file held by the translation unit
+ * and remains valid as long as the translation unit is neither
+ * disposed nor reparsed.
+ */
+StringView Token::text() const
+{
+  details::FileContentsCache cache;
+  return details::range_text(*api, translation_unit, api->clang_getTokenExtent(translation_unit, token), cache);
+}
+
 /**
  * \brief retrieve the source location of the token
  */
@@ -92,5 +106,27 @@ std::string TokenSet::getSpelling() const
   return result;
 }
 
+/**
+ * \brief returns the text of each token of the set
+ *
+ * The content of the file is fetched once for consecutive tokens of the
+ * same file. See Token::text().
+ */
+std::vector<StringView> TokenSet::texts() const
+{
+  std::vector<StringView> result;
+  result.reserve(size());
+
+  details::FileContentsCache cache;
+
+  for (size_t i = 0; i < size(); i++)
+  {
+    CXSourceRange range = api->clang_getTokenExtent(translation_unit, tokens[i]);
+    result.push_back(details::range_text(*api, translation_unit, range, cache));
+  }
+
+  return result;
+}
+
 } // namespace libclang
 
@@ -8,6 +8,7 @@
 #include "libclang-utils/clang-file.h"
 #include "libclang-utils/clang-source-location.h"
 #include "libclang-utils/clang-token.h"
+#include "libclang-utils/skipped-ranges.h"
 
 /*!
  * \namespace libclang
@@ -175,6 +176,46 @@ const char* TranslationUnit::getFileContents(const File& f, size_t* bufsize) con
   return api->clang_getFileContents(*this, f, bufsize);
 }
 
+/**
+ * \brief retrieve the ranges skipped by the preprocessor in a file
+ * 
+ * The translation unit must have been parsed with the 
+ * CXTranslationUnit_DetailedPreprocessingRecord option.
+ * 
+ * Exposes clang_getSkippedRanges().
+ */
+SkippedRanges TranslationUnit::skippedRanges(const File& f) const
+{
+  CXSourceRangeList* list = api->clang_getSkippedRanges(*this, f);
+
+  if (!list)
+    return SkippedRanges();
+
+  SkippedRanges result{ *api, *list };
+  api->clang_disposeSourceRangeList(list);
+  return result;
+}
+
+/**
+ * \brief retrieve the ranges skipped by the preprocessor in all the files of the translation unit
+ * 
+ * The translation unit must have been parsed with the 
+ * CXTranslationUnit_DetailedPreprocessingRecord option.
+ * 
+ * Exposes clang_getAllSkippedRanges().
+ */
+SkippedRanges TranslationUnit::allSkippedRanges() const
+{
+  CXSourceRangeList* list = api->clang_getAllSkippedRanges(*this);
+
+  if (!list)
+    return SkippedRanges();
+
+  SkippedRanges result{ *api, *list };
+  api->clang_disposeSourceRangeList(list);
+  return result;
+}
+
 /*!
  * \endclass
  */
@@ -0,0 +1,142 @@
+// Copyright (C) 2023 Vincent Chambrin
+// This file is part of the 'libclang-utils' project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include "libclang-utils/class-hierarchy.h"
+
+#include "libclang-utils/clang-cursor.h"
+#include "libclang-utils/clang-translation-unit.h"
+
+#include <unordered_set>
+
+namespace libclang
+{
+
+/**
+ * \brief builds the index of a translation unit
+ *
+ * Declarations in function bodies are not visited.
+ */
+ClassHierarchy::ClassHierarchy(const TranslationUnit& tu)
+{
+  LibClang& api = *tu.api;
+
+  tu.getCursor().visitRecursively([&](const Cursor& c, const Cursor& parent) -> VisitResult {
+    CXCursorKind k = api.clang_getCursorKind(c);
+
+    if (k == CXCursor_CXXBaseSpecifier)
+    {
+      SymbolKey derived = symbolKey(parent);
+      SymbolKey base = symbolKey(c.getReference());
+
+      if (!derived.isNull() && !base.isNull())
+        m_inheritance.push_back(SymbolEdge{ derived, base });
+
+      return VisitResult::SkipSubtree;
+    }
+
+    if (!api.clang_isDeclaration(k))
+      return VisitResult::SkipSubtree;
+
+    if (k == CXCursor_CXXMethod || k == CXCursor_Destructor || k == CXCursor_ConversionFunction)
+    {
+      CXCursor* overridden = nullptr;
+      unsigned n = 0;
+      api.clang_getOverriddenCursors(c, &overridden, &n);
+
+      if (n > 0)
+      {
+        SymbolKey method = symbolKey(c);
+
+        for (unsigned i(0); i < n; ++i)
+          m_overrides.push_back(SymbolEdge{ method, symbolKey(Cursor(api, overridden[i])) });
+
+        api.clang_disposeOverriddenCursors(overridden);
+      }
+    }
+
+    return VisitResult::Recurse;
+    });
+
+  build();
+}
+
+/**
+ * \brief returns the classes directly or indirectly derived from a class
+ *
+ * Classes are listed in breadth-first order, each class appearing once.
+ */
+std::vector<SymbolKey> ClassHierarchy::allDerivedClasses(SymbolKey c) const
+{
+  std::vector<SymbolKey> result;
+  std::unordered_set<SymbolKey> visited;
+
+  for (SymbolKey d : derivedClasses(c))
+  {
+    if (visited.insert(d).second)
+      result.push_back(d);
+  }
+
+  for (size_t i(0); i < result.size(); ++i)
+  {
+    for (SymbolKey d : derivedClasses(result[i]))
+    {
+      if (visited.insert(d).second)
+        result.push_back(d);
+    }
+  }
+
+  return result;
+}
+
+/**
+ * \brief adds the relations of another index to this one
+ *
+ * Relations found in both indexes are stored once.
+ */
+void ClassHierarchy::merge(const ClassHierarchy& other)
+{
+  merge(std::vector<const ClassHierarchy*>{ &other });
+}
+
+/**
+ * \brief adds the relations of several indexes to this one
+ *
+ * The index is rebuilt once, prefer this overload to merging the indexes
+ * one at a time.
+ */
+void ClassHierarchy::merge(const std::vector<const ClassHierarchy*>& others)
+{
+  size_t inheritance_count = m_inheritance.size();
+  size_t override_count = m_overrides.size();
+
+  for (const ClassHierarchy* other : others)
+  {
+    inheritance_count += other->m_inheritance.size();
+    override_count += other->m_overrides.size();
+  }
+
+  m_inheritance.reserve(inheritance_count);
+  m_overrides.reserve(override_count);
+
+  for (const ClassHierarchy* other : others)
+  {
+    m_inheritance.insert(m_inheritance.end(), other->m_inheritance.begin(), other->m_inheritance.end());
+    m_overrides.insert(m_overrides.end(), other->m_overrides.begin(), other->m_overrides.end());
+  }
+
+  build();
+}
+
+void ClassHierarchy::build()
+{
+  details::sort_edges(m_inheritance);
+  details::sort_edges(m_overrides);
+
+  m_bases = SymbolAdjacency(m_inheritance);
+  m_derived = SymbolAdjacency(details::reverse_edges(m_inheritance));
+  m_overridden = SymbolAdjacency(m_overrides);
+  m_overriders = SymbolAdjacency(details::reverse_edges(m_overrides));
+}
+
+} // namespace libclang
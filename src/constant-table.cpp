@@ -0,0 +1,128 @@
+// Copyright (C) 2023 Vincent Chambrin
+// This file is part of the 'libclang-utils' project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include "libclang-utils/constant-table.h"
+
+#include "libclang-utils/clang-cursor.h"
+#include "libclang-utils/clang-translation-unit.h"
+#include "libclang-utils/eval-result.h"
+
+namespace libclang
+{
+
+namespace
+{
+
+bool is_unsigned_integer_type(CXTypeKind k)
+{
+  return k >= CXType_Bool && k <= CXType_UInt128;
+}
+
+} // namespace
+
+const ConstantTable::Row ConstantTable::NoRow;
+
+/**
+ * \brief builds the table of the constants of a translation unit
+ */
+ConstantTable::ConstantTable(const TranslationUnit& tu)
+{
+  LibClang& api = *tu.api;
+
+  tu.getCursor().visitRecursively([&](const Cursor& c, const Cursor& parent) -> VisitResult {
+    CXCursorKind k = api.clang_getCursorKind(c);
+
+    if (!api.clang_isDeclaration(k))
+      return VisitResult::SkipSubtree;
+
+    switch (k)
+    {
+    case CXCursor_ClassTemplate:
+    case CXCursor_ClassTemplatePartialSpecialization:
+    case CXCursor_FunctionTemplate:
+    case CXCursor_FunctionDecl:
+    case CXCursor_CXXMethod:
+    case CXCursor_Constructor:
+    case CXCursor_Destructor:
+    case CXCursor_ConversionFunction:
+      return VisitResult::SkipSubtree;
+    case CXCursor_EnumConstantDecl:
+    {
+      SymbolKey symbol = symbolKey(c);
+
+      // the underlying type may be a typedef, e.g. enum E : uint64_t
+      CXType type = api.clang_getCanonicalType(api.clang_getEnumDeclIntegerType(parent));
+
+      if (is_unsigned_integer_type(type.kind))
+        add(symbol, k, UnsignedInteger, api.clang_getEnumConstantDeclUnsignedValue(c));
+      else
+        add(symbol, k, Integer, static_cast<uint64_t>(api.clang_getEnumConstantDeclValue(c)));
+
+      return VisitResult::SkipSubtree;
+    }
+    case CXCursor_VarDecl:
+    {
+      if (!api.clang_isConstQualifiedType(api.clang_getCursorType(c)))
+        return VisitResult::SkipSubtree;
+
+      SymbolKey symbol = symbolKey(c);
+
+      if (symbol.isNull() || find(symbol) != NoRow)
+        return VisitResult::SkipSubtree;
+
+      EvalResult result{ c };
+
+      switch (result.kind())
+      {
+      case CXEval_Int:
+        if (result.isUnsignedInt())
+          add(symbol, k, UnsignedInteger, result.asUnsigned());
+        else
+          add(symbol, k, Integer, static_cast<uint64_t>(result.asLongLong()));
+        break;
+      case CXEval_Float:
+      {
+        double d = result.asDouble();
+        uint64_t bits;
+        std::memcpy(&bits, &d, sizeof(double));
+        add(symbol, k, Float, bits);
+        break;
+      }
+      case CXEval_StrLiteral:
+        add(symbol, k, String, strings.intern(result.asStr()));
+        break;
+      default:
+        break;
+      }
+
+      return VisitResult::SkipSubtree;
+    }
+    default:
+      return VisitResult::Recurse;
+    }
+    });
+}
+
+/**
+ * \brief returns the row of a constant
+ * \return the row, or NoRow if the symbol is not in the table
+ */
+ConstantTable::Row ConstantTable::find(SymbolKey symbol) const
+{
+  auto it = m_rows.find(symbol);
+  return it != m_rows.end() ? it->second : NoRow;
+}
+
+void ConstantTable::add(SymbolKey symbol, CXCursorKind kind, ValueType type, uint64_t value)
+{
+  if (symbol.isNull() || !m_rows.emplace(symbol, static_cast<Row>(symbols.size())).second)
+    return;
+
+  symbols.push_back(symbol);
+  kinds.push_back(kind);
+  types.push_back(type);
+  values.push_back(value);
+}
+
+} // namespace libclang
@@ -0,0 +1,110 @@
+// Copyright (C) 2023 Vincent Chambrin
+// This file is part of the 'libclang-utils' project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include "libclang-utils/cursor-set.h"
+
+#include <algorithm>
+
+namespace libclang
+{
+
+namespace
+{
+
+// no cursor has kind 0, such keys mark the empty slots
+inline bool is_empty_slot(const CursorKey& key)
+{
+  return key.kind == static_cast<CXCursorKind>(0);
+}
+
+inline CursorKey empty_slot()
+{
+  CursorKey key;
+  key.kind = static_cast<CXCursorKind>(0);
+  key.data[0] = key.data[1] = key.data[2] = nullptr;
+  return key;
+}
+
+} // namespace
+
+/**
+ * \brief makes room for at least \a n cursors
+ */
+void FlatCursorSet::reserve(size_t n)
+{
+  size_t capacity = 16;
+
+  // keep the load factor under 1/2
+  while (capacity < 2 * n)
+    capacity *= 2;
+
+  if (capacity > m_slots.size())
+    rehash(capacity);
+}
+
+/**
+ * \brief removes all the cursors from the set
+ */
+void FlatCursorSet::clear()
+{
+  std::fill(m_slots.begin(), m_slots.end(), empty_slot());
+  m_size = 0;
+}
+
+/**
+ * \brief inserts a cursor in the set
+ * \return true if the cursor was not already in the set
+ */
+bool FlatCursorSet::insert(const CXCursor& c)
+{
+  if (2 * (m_size + 1) > m_slots.size())
+    rehash(m_slots.empty() ? 16 : 2 * m_slots.size());
+
+  CursorKey key{ c };
+  size_t i = probe(key);
+
+  if (!is_empty_slot(m_slots[i]))
+    return false;
+
+  m_slots[i] = key;
+  ++m_size;
+  return true;
+}
+
+/**
+ * \brief returns whether a cursor is in the set
+ */
+bool FlatCursorSet::contains(const CXCursor& c) const
+{
+  if (m_slots.empty())
+    return false;
+
+  return !is_empty_slot(m_slots[probe(CursorKey(c))]);
+}
+
+// returns the slot containing the key, or the empty slot where it would be inserted
+size_t FlatCursorSet::probe(const CursorKey& key) const
+{
+  const size_t mask = m_slots.size() - 1;
+  size_t i = hashValue(key) & mask;
+
+  while (!is_empty_slot(m_slots[i]) && m_slots[i] != key)
+    i = (i + 1) & mask;
+
+  return i;
+}
+
+void FlatCursorSet::rehash(size_t capacity)
+{
+  std::vector<CursorKey> slots(capacity, empty_slot());
+  std::swap(slots, m_slots);
+
+  for (const CursorKey& key : slots)
+  {
+    if (!is_empty_slot(key))
+      m_slots[probe(key)] = key;
+  }
+}
+
+} // namespace libclang
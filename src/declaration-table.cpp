@@ -0,0 +1,289 @@
+// Copyright (C) 2023 Vincent Chambrin
+// This file is part of the 'libclang-utils' project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include "libclang-utils/declaration-table.h"
+
+#include "libclang-utils/clang-cursor.h"
+#include "libclang-utils/clang-string.h"
+#include "libclang-utils/clang-translation-unit.h"
+#include "libclang-utils/doc-comment-cache.h"
+#include "libclang-utils/hash.h"
+#include "libclang-utils/thread-pool.h"
+
+#include <stdexcept>
+#include <unordered_map>
+
+namespace libclang
+{
+
+DeclarationTable::DeclarationTable()
+  : unit_offsets{ 0 }
+{
+
+}
+
+/**
+ * \brief creates an empty table
+ * \param fields  a combination of Field values selecting the columns to fill
+ */
+DeclarationTable::DeclarationTable(unsigned fields)
+  : fields(fields),
+    unit_offsets{ 0 }
+{
+
+}
+
+/**
+ * \brief creates a table filled with the declarations of a translation unit
+ */
+DeclarationTable::DeclarationTable(const TranslationUnit& tu, unsigned fields, unsigned options)
+  : DeclarationTable(fields)
+{
+  extract(tu, options);
+}
+
+/**
+ * \brief adds the declarations of a translation unit to the table
+ * \param tu        the translation unit
+ * \param options   a combination of Option values
+ * \param comments  an optional cache for the documentation comments
+ *
+ * With MainFileOnly, declarations that are not in the main file (and
+ * their members) are skipped.
+ */
+void DeclarationTable::extract(const TranslationUnit& tu, unsigned options, DocCommentCache* comments)
+{
+  LibClang& api = *tu.api;
+
+  // file names are interned once per CXFile
+  std::unordered_map<CXFile, StringTable::Id> file_names;
+
+  // hashes of the CXFileUniqueID of each CXFile
+  std::unordered_map<CXFile, uint64_t> file_keys;
+
+  // comments are cached per declaration, identified by its position, and
+  // per combination of comment fields; the position is the same in every
+  // translation unit including the file, no USR needs to be computed
+  auto comment_key = [&](CXFile file, unsigned offset, CXCursorKind k) -> uint64_t {
+    if (!file)
+      return 0;
+
+    auto it = file_keys.find(file);
+
+    if (it == file_keys.end())
+    {
+      CXFileUniqueID uid = CXFileUniqueID{ { 0, 0, 0 } };
+      api.clang_getFileUniqueID(file, &uid);
+      it = file_keys.emplace(file, hash64(uid.data, sizeof(uid.data))).first;
+    }
+
+    uint64_t h = hashCombine(hashCombine(it->second, offset), static_cast<uint64_t>(k));
+    return hashCombine(h, fields & (RawComment | BriefComment));
+  };
+
+  unit_offsets.push_back(unit_offsets.back());
+
+  tu.getCursor().visitRecursively([&](const Cursor& c, const Cursor&) -> VisitResult {
+    CXCursorKind k = api.clang_getCursorKind(c);
+
+    // statements, expressions and references are not visited
+    if (!api.clang_isDeclaration(k))
+      return VisitResult::SkipSubtree;
+
+    // "public:" and the likes are exposed as declarations
+    if (k == CXCursor_CXXAccessSpecifier)
+      return VisitResult::SkipSubtree;
+
+    if ((options & MainFileOnly) && !api.clang_Location_isFromMainFile(api.clang_getCursorLocation(c)))
+      return VisitResult::SkipSubtree;
+
+    if (has(Name))
+    {
+      ClangString str{ api, api.clang_getCursorSpelling(c) };
+      names.push_back(strings.intern(str.view()));
+    }
+
+    if (has(Kind))
+      kinds.push_back(k);
+
+    if (has(Access))
+      accesses.push_back(api.clang_getCXXAccessSpecifier(c));
+
+    if (has(TypeSpelling))
+    {
+      ClangString str{ api, api.clang_getTypeSpelling(api.clang_getCursorType(c)) };
+      types.push_back(strings.intern(str.view()));
+    }
+
+    CXFile file = nullptr;
+    unsigned offset = 0;
+
+    if (has(Location))
+    {
+      unsigned line = 0, col = 0;
+      api.clang_getSpellingLocation(api.clang_getCursorLocation(c), &file, &line, &col, &offset);
+
+      auto it = file_names.find(file);
+
+      if (it == file_names.end())
+      {
+        StringTable::Id id = 0;
+
+        if (file)
+        {
+          ClangString str{ api, api.clang_getFileName(file) };
+          id = strings.intern(str.view());
+        }
+
+        it = file_names.emplace(file, id).first;
+      }
+
+      files.push_back(it->second);
+      lines.push_back(line);
+      columns.push_back(col);
+      offsets.push_back(offset);
+    }
+
+    if (has(DefinitionFlag))
+      definitions.push_back(api.clang_isCursorDefinition(c) ? 1 : 0);
+
+    if (has(Symbol))
+      symbols.push_back(symbolKey(c));
+
+    if (fields & (RawComment | BriefComment))
+    {
+      uint64_t key = 0;
+
+      if (comments)
+      {
+        if (!has(Location))
+          api.clang_getSpellingLocation(api.clang_getCursorLocation(c), &file, nullptr, nullptr, &offset);
+
+        key = comment_key(file, offset, k);
+      }
+
+      DocCommentCache::Comment comment;
+
+      if (key != 0 && comments->find(key, comment))
+      {
+        if (has(RawComment))
+          raw_comments.push_back(strings.intern(comment.raw));
+        if (has(BriefComment))
+          brief_comments.push_back(strings.intern(comment.brief));
+      }
+      else
+      {
+        ClangString raw{ api, api.clang_Cursor_getRawCommentText(c) };
+        ClangString brief;
+
+        // declarations without comment have no brief comment either
+        if (has(BriefComment) && !raw.empty())
+          brief = ClangString(api, api.clang_Cursor_getBriefCommentText(c));
+
+        if (key != 0)
+          comment = comments->insert(key, has(RawComment) ? raw.view() : StringView(), brief.view());
+        else
+          comment = DocCommentCache::Comment{ raw.view(), brief.view() };
+
+        if (has(RawComment))
+          raw_comments.push_back(strings.intern(comment.raw));
+        if (has(BriefComment))
+          brief_comments.push_back(strings.intern(comment.brief));
+      }
+    }
+
+    ++unit_offsets.back();
+
+    return VisitResult::Recurse;
+    });
+}
+
+/**
+ * \brief appends the rows of another table
+ *
+ * Both tables must have the same fields.
+ * The strings of \a other are interned in this table.
+ */
+void DeclarationTable::append(const DeclarationTable& other)
+{
+  if (other.fields != fields)
+    throw std::runtime_error("DeclarationTable::append(): tables have different fields");
+
+  std::vector<StringTable::Id> ids;
+  ids.reserve(other.strings.size());
+
+  for (StringTable::Id i(0); i < other.strings.size(); ++i)
+    ids.push_back(strings.intern(other.strings.get(i)));
+
+  for (StringTable::Id id : other.names)
+    names.push_back(ids[id]);
+
+  kinds.insert(kinds.end(), other.kinds.begin(), other.kinds.end());
+  accesses.insert(accesses.end(), other.accesses.begin(), other.accesses.end());
+
+  for (StringTable::Id id : other.types)
+    types.push_back(ids[id]);
+
+  for (StringTable::Id id : other.files)
+    files.push_back(ids[id]);
+
+  lines.insert(lines.end(), other.lines.begin(), other.lines.end());
+  columns.insert(columns.end(), other.columns.begin(), other.columns.end());
+  offsets.insert(offsets.end(), other.offsets.begin(), other.offsets.end());
+  definitions.insert(definitions.end(), other.definitions.begin(), other.definitions.end());
+  symbols.insert(symbols.end(), other.symbols.begin(), other.symbols.end());
+
+  for (StringTable::Id id : other.raw_comments)
+    raw_comments.push_back(ids[id]);
+
+  for (StringTable::Id id : other.brief_comments)
+    brief_comments.push_back(ids[id]);
+
+  uint32_t base = unit_offsets.back();
+
+  for (size_t i(1); i < other.unit_offsets.size(); ++i)
+    unit_offsets.push_back(base + other.unit_offsets[i]);
+}
+
+/**
+ * \brief extracts the declarations of several translation units in parallel
+ * \param pool      the thread pool
+ * \param units     the translation units
+ * \param fields    a combination of DeclarationTable::Field values
+ * \param options   a combination of DeclarationTable::Option values
+ * \param comments  an optional cache for the documentation comments
+ *
+ * Each translation unit is processed by a single thread into its own
+ * table; the tables are then appended in the order of \a units.
+ *
+ * If comments are requested and no cache is provided, a cache is used
+ * for the duration of the call so that comments of declarations shared
+ * by several translation units are only extracted once.
+ */
+DeclarationTable extractDeclarations(ThreadPool& pool, const std::vector<const TranslationUnit*>& units, unsigned fields, unsigned options, DocCommentCache* comments)
+{
+  DocCommentCache local_cache;
+
+  if (!comments && (fields & (DeclarationTable::RawComment | DeclarationTable::BriefComment)))
+    comments = &local_cache;
+
+  std::vector<DeclarationTable> tables;
+  tables.reserve(units.size());
+
+  for (size_t i(0); i < units.size(); ++i)
+    tables.emplace_back(fields);
+
+  pool.parallelFor(units.size(), [&](size_t i) {
+    tables[i].extract(*units[i], options, comments);
+    });
+
+  DeclarationTable result{ fields };
+
+  for (const DeclarationTable& t : tables)
+    result.append(t);
+
+  return result;
+}
+
+} // namespace libclang
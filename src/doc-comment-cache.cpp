@@ -0,0 +1,62 @@
+// Copyright (C) 2023 Vincent Chambrin
+// This file is part of the 'libclang-utils' project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include "libclang-utils/doc-comment-cache.h"
+
+namespace libclang
+{
+
+/**
+ * \brief returns the number of comments in the cache
+ */
+size_t DocCommentCache::size() const
+{
+  std::lock_guard<std::mutex> lock{ m_mutex };
+  return m_comments.size();
+}
+
+/**
+ * \brief searches for a comment
+ * \param key      the key of the declaration
+ * \param comment  receives the comment if it is found
+ * \return whether the comment was found
+ */
+bool DocCommentCache::find(uint64_t key, Comment& comment) const
+{
+  std::lock_guard<std::mutex> lock{ m_mutex };
+
+  auto it = m_comments.find(key);
+
+  if (it == m_comments.end())
+    return false;
+
+  comment.raw = m_strings.get(it->second.first);
+  comment.brief = m_strings.get(it->second.second);
+  ++m_hits;
+  return true;
+}
+
+/**
+ * \brief adds a comment to the cache
+ * \return the comment stored in the cache
+ *
+ * If another thread already added a comment with the same key, that
+ * comment is kept and returned.
+ */
+DocCommentCache::Comment DocCommentCache::insert(uint64_t key, StringView raw, StringView brief)
+{
+  std::lock_guard<std::mutex> lock{ m_mutex };
+
+  auto it = m_comments.find(key);
+
+  if (it == m_comments.end())
+  {
+    auto ids = std::make_pair(m_strings.intern(raw), m_strings.intern(brief));
+    it = m_comments.emplace(key, ids).first;
+  }
+
+  return Comment{ m_strings.get(it->second.first), m_strings.get(it->second.second) };
+}
+
+} // namespace libclang
@@ -0,0 +1,25 @@
+// Copyright (C) 2023 Vincent Chambrin
+// This file is part of the 'libclang-utils' project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include "libclang-utils/eval-result.h"
+
+#include "libclang-utils/clang-cursor.h"
+
+namespace libclang
+{
+
+/**
+ * \brief evaluates a cursor
+ *
+ * The cursor may be an expression or a variable declaration, in which
+ * case its initializer is evaluated.
+ */
+EvalResult::EvalResult(const Cursor& c)
+  : api(c.api),
+    result(c.api->clang_Cursor_Evaluate(c))
+{
+
+}
+
+} // namespace libclang
@@ -0,0 +1,218 @@
+// Copyright (C) 2023 Vincent Chambrin
+// This file is part of the 'libclang-utils' project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include "libclang-utils/extent-index.h"
+
+#include <algorithm>
+#include <numeric>
+
+namespace libclang
+{
+
+namespace
+{
+
+bool contains(const ExtentIndex::Interval& i, unsigned offset)
+{
+  return i.begin <= offset && offset < i.end;
+}
+
+// returns a permutation that sorts the offsets, or an empty vector if
+// they are already sorted
+std::vector<size_t> sort_order(const std::vector<unsigned>& offsets)
+{
+  std::vector<size_t> order;
+
+  if (std::is_sorted(offsets.begin(), offsets.end()))
+    return order;
+
+  order.resize(offsets.size());
+  std::iota(order.begin(), order.end(), size_t(0));
+  std::stable_sort(order.begin(), order.end(), [&offsets](size_t a, size_t b) {
+    return offsets[a] < offsets[b];
+    });
+
+  return order;
+}
+
+/*
+ * Sweeps the intervals and the sorted offsets simultaneously, maintaining
+ * the stack of the intervals enclosing the current offset.
+ * The callback is invoked for each offset with the stack (outermost first).
+ */
+template<typename F>
+void sweep(const std::vector<ExtentIndex::Interval>& intervals, const std::vector<unsigned>& offsets, F&& f)
+{
+  std::vector<size_t> order = sort_order(offsets);
+  std::vector<const ExtentIndex::Interval*> stack;
+  size_t next = 0;
+
+  for (size_t k(0); k < offsets.size(); ++k)
+  {
+    size_t i = order.empty() ? k : order[k];
+    unsigned offset = offsets[i];
+
+    while (next < intervals.size() && intervals[next].begin <= offset)
+    {
+      const ExtentIndex::Interval& interval = intervals[next++];
+
+      while (!stack.empty() && stack.back()->end <= interval.begin)
+        stack.pop_back();
+
+      stack.push_back(&interval);
+    }
+
+    while (!stack.empty() && stack.back()->end <= offset)
+      stack.pop_back();
+
+    f(i, stack);
+  }
+}
+
+} // namespace
+
+const uint32_t ExtentIndex::NoInterval;
+
+/**
+ * \brief builds the index of a snapshot
+ *
+ * Nodes without a file or with an empty extent are not indexed.
+ */
+ExtentIndex::ExtentIndex(const AstSnapshot& snapshot)
+{
+  m_files.resize(snapshot.file_table.size());
+
+  for (NodeId n(0); n < snapshot.size(); ++n)
+  {
+    FileTable::Id file = snapshot.file(n);
+
+    if (file == FileTable::NoFile || file >= m_files.size() || snapshot.beginOffset(n) >= snapshot.endOffset(n))
+      continue;
+
+    m_files[file].push_back(Interval{ snapshot.beginOffset(n), snapshot.endOffset(n), n, NoInterval });
+  }
+
+  for (std::vector<Interval>& intervals : m_files)
+  {
+    // outer intervals first; for identical extents, the deepest node last
+    std::sort(intervals.begin(), intervals.end(), [](const Interval& a, const Interval& b) {
+      return a.begin < b.begin || (a.begin == b.begin && (a.end > b.end || (a.end == b.end && a.node < b.node)));
+      });
+
+    std::vector<uint32_t> stack;
+
+    for (uint32_t i(0); i < intervals.size(); ++i)
+    {
+      while (!stack.empty() && intervals[stack.back()].end <= intervals[i].begin)
+        stack.pop_back();
+
+      intervals[i].enclosing = stack.empty() ? NoInterval : stack.back();
+      stack.push_back(i);
+    }
+  }
+}
+
+uint32_t ExtentIndex::find(const std::vector<Interval>& intervals, unsigned offset) const
+{
+  // last interval starting at or before the offset
+  auto it = std::upper_bound(intervals.begin(), intervals.end(), offset, [](unsigned off, const Interval& i) {
+    return off < i.begin;
+    });
+
+  if (it == intervals.begin())
+    return NoInterval;
+
+  auto index = static_cast<uint32_t>(std::distance(intervals.begin(), it) - 1);
+
+  while (index != NoInterval && !contains(intervals[index], offset))
+    index = intervals[index].enclosing;
+
+  return index;
+}
+
+/**
+ * \brief returns the innermost node whose extent contains an offset
+ * \return the node, or NoNode if no node contains the offset
+ */
+ExtentIndex::NodeId ExtentIndex::innermost(FileTable::Id file, unsigned offset) const
+{
+  const std::vector<Interval>& intervals = m_files.at(file);
+  uint32_t index = find(intervals, offset);
+  return index != NoInterval ? intervals[index].node : AstSnapshot::NoNode;
+}
+
+/**
+ * \brief returns the nodes whose extent contains an offset
+ *
+ * Nodes are listed from the outermost to the innermost.
+ */
+std::vector<ExtentIndex::NodeId> ExtentIndex::enclosing(FileTable::Id file, unsigned offset) const
+{
+  const std::vector<Interval>& intervals = m_files.at(file);
+  std::vector<NodeId> result;
+
+  for (uint32_t index = find(intervals, offset); index != NoInterval; index = intervals[index].enclosing)
+    result.push_back(intervals[index].node);
+
+  std::reverse(result.begin(), result.end());
+  return result;
+}
+
+/**
+ * \brief returns the innermost node at each offset of a batch
+ * \param file     the file id
+ * \param offsets  the offsets
+ * \return a vector with one node (or NoNode) per offset
+ *
+ * If the offsets are sorted, this runs in linear time in the number of
+ * offsets and intervals; otherwise the offsets are sorted first.
+ */
+std::vector<ExtentIndex::NodeId> ExtentIndex::innermost(FileTable::Id file, const std::vector<unsigned>& offsets) const
+{
+  std::vector<NodeId> result(offsets.size(), AstSnapshot::NoNode);
+
+  sweep(m_files.at(file), offsets, [&result](size_t i, const std::vector<const Interval*>& stack) {
+    if (!stack.empty())
+      result[i] = stack.back()->node;
+    });
+
+  return result;
+}
+
+/**
+ * \brief returns the nodes enclosing each offset of a batch
+ * \param file     the file id
+ * \param offsets  the offsets
+ * \return one list per offset, from the outermost to the innermost node
+ *
+ * See innermost() for complexity.
+ */
+NodeLists ExtentIndex::enclosing(FileTable::Id file, const std::vector<unsigned>& offsets) const
+{
+  std::vector<std::pair<uint32_t, uint32_t>> ranges(offsets.size());
+  std::vector<NodeId> nodes;
+
+  sweep(m_files.at(file), offsets, [&](size_t i, const std::vector<const Interval*>& stack) {
+    ranges[i].first = static_cast<uint32_t>(nodes.size());
+    for (const Interval* interval : stack)
+      nodes.push_back(interval->node);
+    ranges[i].second = static_cast<uint32_t>(nodes.size());
+    });
+
+  // lists are produced in sorted offset order, lay them out in input order
+  NodeLists result;
+  result.offsets.reserve(offsets.size() + 1);
+  result.nodes.reserve(nodes.size());
+  result.offsets.push_back(0);
+
+  for (const auto& r : ranges)
+  {
+    result.nodes.insert(result.nodes.end(), nodes.begin() + r.first, nodes.begin() + r.second);
+    result.offsets.push_back(static_cast<uint32_t>(result.nodes.size()));
+  }
+
+  return result;
+}
+
+} // namespace libclang
@@ -0,0 +1,126 @@
+// Copyright (C) 2023 Vincent Chambrin
+// This file is part of the 'libclang-utils' project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include "libclang-utils/file-table.h"
+
+#include "libclang-utils/clang-translation-unit.h"
+
+namespace libclang
+{
+
+namespace
+{
+
+struct InclusionVisitorData
+{
+  const TranslationUnit& tu;
+  FileTable& table;
+};
+
+void inclusion_visitor(CXFile included_file, CXSourceLocation*, unsigned include_len, CXClientData client_data)
+{
+  auto& data = *static_cast<InclusionVisitorData*>(client_data);
+  data.table.insert(data.tu, included_file, include_len);
+}
+
+} // namespace
+
+const FileTable::Id FileTable::NoFile;
+
+/**
+ * \brief builds the table of the files of a translation unit
+ *
+ * Exposes clang_getInclusions().
+ */
+FileTable::FileTable(const TranslationUnit& tu)
+  : m_api(tu.api)
+{
+  InclusionVisitorData data{ tu, *this };
+  m_api->clang_getInclusions(tu, &inclusion_visitor, &data);
+}
+
+/**
+ * \brief returns the id of a file
+ * \return the id, or NoFile if the file is not in the table
+ */
+FileTable::Id FileTable::find(CXFile file) const
+{
+  if (!file)
+    return NoFile;
+
+  auto it = m_by_handle.find(file);
+
+  if (it != m_by_handle.end())
+    return it->second;
+
+  // the same file may be referred to by several CXFile
+  CXFileUniqueID uid;
+
+  if (m_api && m_api->clang_getFileUniqueID(file, &uid) == 0)
+  {
+    auto uit = m_by_unique_id.find(uid);
+
+    if (uit != m_by_unique_id.end())
+      return uit->second;
+  }
+
+  return NoFile;
+}
+
+/**
+ * \brief adds a file to the table
+ * \param tu     the translation unit the file belongs to
+ * \param file   the file
+ * \param depth  the include depth of the file
+ * \return the id of the file
+ *
+ * If the file is already in the table, its id is returned and the
+ * table is not modified.
+ */
+FileTable::Id FileTable::insert(const TranslationUnit& tu, CXFile file, unsigned depth)
+{
+  auto it = m_by_handle.find(file);
+
+  if (it != m_by_handle.end())
+    return it->second;
+
+  m_api = tu.api;
+
+  Entry entry;
+  entry.file = file;
+  entry.depth = depth;
+  entry.size = 0;
+
+  if (m_api->clang_getFileUniqueID(file, &entry.unique_id) == 0)
+  {
+    auto uit = m_by_unique_id.find(entry.unique_id);
+
+    if (uit != m_by_unique_id.end())
+    {
+      m_by_handle[file] = uit->second;
+      return uit->second;
+    }
+  }
+  else
+  {
+    entry.unique_id = CXFileUniqueID{ { 0, 0, 0 } };
+  }
+
+  CXString name = m_api->clang_getFileName(file);
+  entry.name = m_names.intern(StringView(m_api->clang_getCString(name)));
+  m_api->clang_disposeString(name);
+
+  m_api->clang_getFileContents(tu, file, &entry.size);
+
+  Id id = static_cast<Id>(m_files.size());
+  m_files.push_back(entry);
+  m_by_handle[file] = id;
+
+  if (entry.unique_id.data[0] || entry.unique_id.data[1] || entry.unique_id.data[2])
+    m_by_unique_id[entry.unique_id] = id;
+
+  return id;
+}
+
+} // namespace libclang
@@ -0,0 +1,229 @@
+// Copyright (C) 2023 Vincent Chambrin
+// This file is part of the 'libclang-utils' project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include "libclang-utils/line-index.h"
+
+#include "libclang-utils/clang-file.h"
+#include "libclang-utils/clang-translation-unit.h"
+
+#include <algorithm>
+
+#if defined(__AVX2__)
+#  define LIBCLANGUTILS_LINEINDEX_AVX2
+#  include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define LIBCLANGUTILS_LINEINDEX_SSE2
+#  include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#  include <intrin.h>
+#endif
+
+namespace libclang
+{
+
+namespace details
+{
+
+// the last line break character seen, carried across SIMD blocks
+struct LineBreakState
+{
+  size_t last = static_cast<size_t>(-1);
+  bool paired = false; // whether the last character ended the line break started before it
+};
+
+static inline void handle_line_break(const char* data, size_t i, LineBreakState& state, std::vector<unsigned>& line_starts)
+{
+  // like clang, "\r\n" and "\n\r" are single line breaks: a '\r' or '\n'
+  // following the other character ends the line break it started, unless
+  // that character already ended one
+  if (i > 0 && state.last == i - 1 && data[i - 1] != data[i] && !state.paired)
+  {
+    line_starts.back() = static_cast<unsigned>(i + 1);
+    state.paired = true;
+  }
+  else
+  {
+    line_starts.push_back(static_cast<unsigned>(i + 1));
+    state.paired = false;
+  }
+
+  state.last = i;
+}
+
+#if defined(LIBCLANGUTILS_LINEINDEX_AVX2) || defined(LIBCLANGUTILS_LINEINDEX_SSE2)
+
+static inline unsigned count_trailing_zeros(unsigned mask)
+{
+#if defined(_MSC_VER)
+  unsigned long index;
+  _BitScanForward(&index, mask);
+  return static_cast<unsigned>(index);
+#else
+  return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+}
+
+#endif
+
+/**
+ * \brief computes the line starts of a buffer without SIMD instructions
+ */
+void scan_line_starts_scalar(const char* data, size_t size, std::vector<unsigned>& line_starts)
+{
+  line_starts.push_back(0);
+  LineBreakState state;
+
+  for (size_t i(0); i < size; ++i)
+  {
+    if (data[i] == '\n' || data[i] == '\r')
+      handle_line_break(data, i, state, line_starts);
+  }
+}
+
+/**
+ * \brief computes the line starts of a buffer
+ *
+ * Uses AVX2 or SSE2 instructions if they were enabled at compile time,
+ * and falls back to scan_line_starts_scalar() otherwise.
+ */
+void scan_line_starts(const char* data, size_t size, std::vector<unsigned>& line_starts)
+{
+#if defined(LIBCLANGUTILS_LINEINDEX_AVX2)
+
+  line_starts.push_back(0);
+  LineBreakState state;
+
+  const __m256i lf = _mm256_set1_epi8('\n');
+  const __m256i cr = _mm256_set1_epi8('\r');
+
+  size_t i = 0;
+
+  for (; i + 32 <= size; i += 32)
+  {
+    __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+    __m256i matches = _mm256_or_si256(_mm256_cmpeq_epi8(block, lf), _mm256_cmpeq_epi8(block, cr));
+    unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(matches));
+
+    while (mask)
+    {
+      handle_line_break(data, i + count_trailing_zeros(mask), state, line_starts);
+      mask &= mask - 1;
+    }
+  }
+
+  for (; i < size; ++i)
+  {
+    if (data[i] == '\n' || data[i] == '\r')
+      handle_line_break(data, i, state, line_starts);
+  }
+
+#elif defined(LIBCLANGUTILS_LINEINDEX_SSE2)
+
+  line_starts.push_back(0);
+  LineBreakState state;
+
+  const __m128i lf = _mm_set1_epi8('\n');
+  const __m128i cr = _mm_set1_epi8('\r');
+
+  size_t i = 0;
+
+  for (; i + 16 <= size; i += 16)
+  {
+    __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+    __m128i matches = _mm_or_si128(_mm_cmpeq_epi8(block, lf), _mm_cmpeq_epi8(block, cr));
+    unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(matches));
+
+    while (mask)
+    {
+      handle_line_break(data, i + count_trailing_zeros(mask), state, line_starts);
+      mask &= mask - 1;
+    }
+  }
+
+  for (; i < size; ++i)
+  {
+    if (data[i] == '\n' || data[i] == '\r')
+      handle_line_break(data, i, state, line_starts);
+  }
+
+#else
+
+  scan_line_starts_scalar(data, size, line_starts);
+
+#endif
+}
+
+} // namespace details
+
+/**
+ * \brief constructs an index of an empty buffer
+ */
+LineIndex::LineIndex()
+{
+  m_line_starts.push_back(0);
+}
+
+/**
+ * \brief builds the index of a buffer
+ */
+LineIndex::LineIndex(const char* data, size_t size)
+  : m_data(data), m_size(size)
+{
+  // a rough estimate that avoids most reallocations for source code
+  m_line_starts.reserve(size / 32 + 1);
+  details::scan_line_starts(data, size, m_line_starts);
+}
+
+/**
+ * \brief builds the index of a file of a translation unit
+ *
+ * The content of the file is retrieved with TranslationUnit::getFileContents().
+ */
+LineIndex::LineIndex(const TranslationUnit& tu, const File& file)
+{
+  size_t size = 0;
+  const char* data = tu.getFileContents(file, &size);
+  *this = LineIndex(data, data ? size : 0);
+}
+
+/**
+ * \brief returns the offset of the first character of a line
+ * \param line  the line number, starting at 1
+ *
+ * Throws std::out_of_range if the line does not exist.
+ */
+unsigned LineIndex::lineStart(unsigned line) const
+{
+  return m_line_starts.at(line - 1);
+}
+
+/**
+ * \brief converts an offset to a (line, column) pair
+ *
+ * This function has logarithmic complexity in the number of lines.
+ */
+LineColumn LineIndex::lineColumn(unsigned offset) const
+{
+  auto it = std::upper_bound(m_line_starts.begin(), m_line_starts.end(), offset);
+  --it;
+
+  LineColumn result;
+  result.line = static_cast<unsigned>(std::distance(m_line_starts.begin(), it)) + 1;
+  result.column = offset - *it + 1;
+  return result;
+}
+
+/**
+ * \brief converts a (line, column) pair to an offset
+ *
+ * Throws std::out_of_range if the line does not exist.
+ */
+unsigned LineIndex::offset(unsigned line, unsigned column) const
+{
+  return lineStart(line) + column - 1;
+}
+
+} // namespace libclang
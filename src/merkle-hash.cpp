@@ -0,0 +1,227 @@
+// Copyright (C) 2023 Vincent Chambrin
+// This file is part of the 'libclang-utils' project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include "libclang-utils/merkle-hash.h"
+
+#include "libclang-utils/ast-snapshot.h"
+#include "libclang-utils/clang-source-range.h"
+#include "libclang-utils/hash.h"
+
+#include <cctype>
+
+namespace libclang
+{
+
+namespace details
+{
+
+/**
+ * \brief removes the source locations from a spelling
+ *
+ * Spellings of unnamed entities, like "(unnamed struct at test.cpp:3:1)",
+ * contain the location of the entity, which would otherwise make their
+ * hash depend on where they are.
+ */
+std::string normalize_spelling(std::string spelling)
+{
+  size_t pos = 0;
+
+  while ((pos = spelling.find(" at ", pos)) != std::string::npos)
+  {
+    size_t open = spelling.rfind('(', pos);
+    size_t close = spelling.find(')', pos);
+
+    if (open == std::string::npos || close == std::string::npos
+      || (spelling.compare(open, 8, "(unnamed") != 0 && spelling.compare(open, 10, "(anonymous") != 0))
+    {
+      pos += 4;
+      continue;
+    }
+
+    spelling.erase(pos, close - pos);
+  }
+
+  return spelling;
+}
+
+} // namespace details
+
+namespace
+{
+
+std::string take_string(LibClang& api, CXString str)
+{
+  const char* cstr = api.clang_getCString(str);
+  std::string result = cstr ? cstr : "";
+  api.clang_disposeString(str);
+  return result;
+}
+
+struct OperatorData
+{
+  LibClang& api;
+  CXTranslationUnit tu;
+  details::FileContentsCache& contents;
+  StringView text;
+  std::string spelling;
+  const char* pos;
+};
+
+void append_operator_chars(std::string& out, const char* begin, const char* end)
+{
+  for (const char* it = begin; it < end; ++it)
+  {
+    if (!std::isspace(static_cast<unsigned char>(*it)))
+      out.push_back(*it);
+  }
+}
+
+CXChildVisitResult operator_visitor(CXCursor c, CXCursor, CXClientData client_data)
+{
+  auto& data = *static_cast<OperatorData*>(client_data);
+  StringView child = details::range_text(data.api, data.tu, data.api.clang_getCursorExtent(c), data.contents);
+
+  // children expanded from another file (e.g. a macro) are not part of the text
+  if (child.begin() < data.pos || child.end() > data.text.end())
+    return CXChildVisit_Continue;
+
+  append_operator_chars(data.spelling, data.pos, child.begin());
+  data.pos = child.end();
+  return CXChildVisit_Continue;
+}
+
+/*
+ * Returns the source text of an operator expression that is not covered by
+ * its operands, i.e. the operator tokens ("+", "-=", "++", "?:", ...),
+ * without whitespace.
+ */
+std::string operator_spelling(LibClang& api, const CXCursor& c, details::FileContentsCache& contents)
+{
+  CXTranslationUnit tu = api.clang_Cursor_getTranslationUnit(c);
+  StringView text = details::range_text(api, tu, api.clang_getCursorExtent(c), contents);
+
+  if (text.empty())
+    return {};
+
+  OperatorData data{ api, tu, contents, text, std::string(), text.begin() };
+  api.clang_visitChildren(c, operator_visitor, &data);
+  append_operator_chars(data.spelling, data.pos, text.end());
+  return data.spelling;
+}
+
+/*
+ * Computes the hash of a node without its children: kind, normalized
+ * spelling (source text for literals, operator tokens for operators) and
+ * type spelling.
+ */
+uint64_t local_hash(LibClang& api, const CXCursor& c, details::FileContentsCache& contents)
+{
+  uint64_t h = hash64(&c.kind, sizeof(c.kind));
+
+  switch (c.kind)
+  {
+  case CXCursor_IntegerLiteral:
+  case CXCursor_FloatingLiteral:
+  case CXCursor_ImaginaryLiteral:
+  case CXCursor_StringLiteral:
+  case CXCursor_CharacterLiteral:
+  case CXCursor_CXXBoolLiteralExpr:
+  case CXCursor_CXXNullPtrLiteralExpr:
+  {
+    StringView text = details::range_text(api, api.clang_Cursor_getTranslationUnit(c), api.clang_getCursorExtent(c), contents);
+    h = hash64(text, h);
+  }
+  break;
+  case CXCursor_UnaryOperator:
+  case CXCursor_BinaryOperator:
+  case CXCursor_CompoundAssignOperator:
+  case CXCursor_ConditionalOperator:
+    h = hash64(operator_spelling(api, c, contents), h);
+    break;
+  default:
+    h = hash64(details::normalize_spelling(take_string(api, api.clang_getCursorSpelling(c))), h);
+    break;
+  }
+
+  CXType type = api.clang_getCursorType(c);
+
+  if (type.kind != CXType_Invalid)
+    h = hash64(details::normalize_spelling(take_string(api, api.clang_getTypeSpelling(type))), h);
+
+  return h;
+}
+
+struct LiveHashData
+{
+  LibClang& api;
+  details::FileContentsCache& contents;
+  uint64_t hash;
+};
+
+uint64_t live_hash(LibClang& api, CXCursor c, details::FileContentsCache& contents);
+
+CXChildVisitResult live_hash_visitor(CXCursor c, CXCursor, CXClientData client_data)
+{
+  auto& data = *static_cast<LiveHashData*>(client_data);
+  data.hash = hashCombine(data.hash, live_hash(data.api, c, data.contents));
+  return CXChildVisit_Continue;
+}
+
+uint64_t live_hash(LibClang& api, CXCursor c, details::FileContentsCache& contents)
+{
+  LiveHashData data{ api, contents, local_hash(api, c, contents) };
+  api.clang_visitChildren(c, live_hash_visitor, &data);
+  return data.hash;
+}
+
+} // namespace
+
+/**
+ * \brief computes the structural hash of the subtree of a cursor
+ *
+ * The hash of a node combines its kind, its spelling (or its source text
+ * for literals and its operator tokens for operator expressions), the spelling of its type and the hashes of its children,
+ * in order.
+ * Source locations are not part of the hash, so identical subtrees have
+ * the same hash wherever they are; this can be used to detect changes,
+ * as a cache key or to find duplicated code.
+ *
+ * The whole subtree is traversed; when the hashes of many nodes are
+ * needed, structuralHashes() computes them in a single pass.
+ */
+uint64_t structuralHash(const Cursor& c)
+{
+  details::FileContentsCache contents;
+  return live_hash(*c.api, c, contents);
+}
+
+/**
+ * \brief computes the structural hash of each node of a snapshot
+ *
+ * Hashes are computed bottom-up, each node being processed once, and are
+ * equal to the value structuralHash() returns for the node's cursor.
+ * The translation unit must still be alive.
+ */
+std::vector<uint64_t> structuralHashes(const AstSnapshot& snapshot)
+{
+  LibClang& api = *snapshot.api;
+  std::vector<uint64_t> hashes(snapshot.size());
+  details::FileContentsCache contents;
+
+  // children have greater ids than their parent
+  for (size_t i = snapshot.size(); i-- > 0;)
+  {
+    auto n = static_cast<AstSnapshot::NodeId>(i);
+    uint64_t h = local_hash(api, snapshot.cursors[n], contents);
+
+    for (size_t j(0); j < snapshot.childCount(n); ++j)
+      h = hashCombine(h, hashes[snapshot.childAt(n, j)]);
+
+    hashes[n] = h;
+  }
+
+  return hashes;
+}
+
+} // namespace libclang
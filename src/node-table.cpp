@@ -0,0 +1,109 @@
+// Copyright (C) 2023 Vincent Chambrin
+// This file is part of the 'libclang-utils' project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include "libclang-utils/node-table.h"
+
+#include "libclang-utils/ast-snapshot.h"
+#include "libclang-utils/clang-token.h"
+#include "libclang-utils/clang-translation-unit.h"
+
+namespace libclang
+{
+
+const NodeTable::NodeId NodeTable::NoNode;
+
+/**
+ * \brief constructs an empty table
+ */
+NodeTable::NodeTable(LibClang& api)
+  : m_api(&api)
+{
+
+}
+
+/**
+ * \brief constructs a table containing the nodes of a snapshot
+ *
+ * The handle of each node is its id in the snapshot.
+ */
+NodeTable::NodeTable(const AstSnapshot& snapshot)
+  : m_api(snapshot.api)
+{
+  m_cursors.reserve(snapshot.size());
+  m_ids.reserve(snapshot.size());
+
+  for (const CXCursor& c : snapshot.cursors)
+  {
+    // a cursor that appears twice gets the handle of its first occurrence,
+    // so keep the vector aligned with the node ids of the snapshot
+    m_ids.emplace(CursorKey(c), static_cast<NodeId>(m_cursors.size()));
+    m_cursors.push_back(c);
+  }
+}
+
+/**
+ * \brief adds a cursor to the table
+ * \return the handle of the cursor
+ *
+ * If an equal cursor is already in the table, its handle is returned.
+ */
+NodeTable::NodeId NodeTable::insert(const CXCursor& c)
+{
+  auto result = m_ids.emplace(CursorKey(c), static_cast<NodeId>(m_cursors.size()));
+
+  if (result.second)
+    m_cursors.push_back(c);
+
+  return result.first->second;
+}
+
+/**
+ * \brief returns the handle of a cursor
+ * \return the handle, or NoNode if the cursor is not in the table
+ */
+NodeTable::NodeId NodeTable::find(const CXCursor& c) const
+{
+  auto it = m_ids.find(CursorKey(c));
+  return it != m_ids.end() ? it->second : NoNode;
+}
+
+/**
+ * \brief returns the handles of the children of a node
+ *
+ * Children that are not in the table yet are added to it.
+ */
+std::vector<NodeTable::NodeId> NodeTable::children(NodeId n)
+{
+  std::vector<NodeId> result;
+
+  cursor(n).visitChildren([this, &result](const Cursor& c) {
+    result.push_back(insert(c));
+    });
+
+  return result;
+}
+
+/**
+ * \brief returns the handles of the cursors associated with a set of tokens
+ *
+ * This is the compact equivalent of annotateTokens(tu, tokens).
+ * Cursors that are not in the table yet are added to it.
+ */
+std::vector<NodeTable::NodeId> NodeTable::annotateTokens(const TranslationUnit& tu, const TokenSet& tokens)
+{
+  std::vector<CXCursor> cursors;
+  cursors.resize(tokens.size());
+
+  tu.api->clang_annotateTokens(tu, tokens.data(), static_cast<unsigned int>(tokens.size()), cursors.data());
+
+  std::vector<NodeId> result;
+  result.reserve(cursors.size());
+
+  for (const CXCursor& c : cursors)
+    result.push_back(insert(c));
+
+  return result;
+}
+
+} // namespace libclang
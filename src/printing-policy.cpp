@@ -0,0 +1,60 @@
+// Copyright (C) 2023 Vincent Chambrin
+// This file is part of the 'libclang-utils' project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include "libclang-utils/printing-policy.h"
+
+#include "libclang-utils/clang-cursor.h"
+#include "libclang-utils/clang-translation-unit.h"
+
+namespace libclang
+{
+
+/**
+ * \brief creates the default policy of the translation unit of a cursor
+ *
+ * Exposes clang_getCursorPrintingPolicy().
+ */
+PrintingPolicy::PrintingPolicy(const Cursor& c)
+  : api(c.api),
+    policy(c.api->clang_getCursorPrintingPolicy(c))
+{
+
+}
+
+/**
+ * \brief creates a policy suited to printing the signatures of declarations
+ *
+ * Bodies and implicit base expressions are not printed
+ * and the output fits on a single line.
+ */
+PrintingPolicy PrintingPolicy::forDeclarations(const Cursor& c)
+{
+  PrintingPolicy result{ c };
+  result.set(CXPrintingPolicy_TerseOutput, 1);
+  result.set(CXPrintingPolicy_PolishForDeclaration, 1);
+  result.set(CXPrintingPolicy_SuppressImplicitBase, 1);
+  result.set(CXPrintingPolicy_IncludeNewlines, 0);
+  return result;
+}
+
+/**
+ * \brief creates the policy used to print the declarations of a translation unit
+ */
+DeclarationPrinter::DeclarationPrinter(const TranslationUnit& tu)
+  : m_policy(PrintingPolicy::forDeclarations(tu.getCursor()))
+{
+
+}
+
+/**
+ * \brief prints the declaration of a cursor
+ *
+ * See Cursor::prettyPrinted().
+ */
+ClangString DeclarationPrinter::print(const Cursor& c) const
+{
+  return c.prettyPrinted(m_policy);
+}
+
+} // namespace libclang
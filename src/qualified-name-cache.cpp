@@ -0,0 +1,145 @@
+// Copyright (C) 2023 Vincent Chambrin
+// This file is part of the 'libclang-utils' project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include "libclang-utils/qualified-name-cache.h"
+
+namespace libclang
+{
+
+namespace
+{
+
+// declaration contexts that don't add a scope to the names they contain:
+// extern "C" blocks, and export declarations which libclang doesn't expose
+bool is_transparent_context(CXCursorKind k)
+{
+  return k == CXCursor_LinkageSpec || k == CXCursor_UnexposedDecl;
+}
+
+} // namespace
+
+const QualifiedNameCache::EntryId QualifiedNameCache::NoEntry;
+
+/**
+ * \brief constructs an empty cache
+ */
+QualifiedNameCache::QualifiedNameCache(LibClang& api)
+  : m_api(&api)
+{
+
+}
+
+/**
+ * \brief returns the entry of a declaration, adding it to the cache if needed
+ *
+ * The entries of the semantic parents of the declaration are also added.
+ * extern "C" blocks and export declarations are skipped, so that their
+ * content is named as if it were declared in the enclosing scope.
+ */
+QualifiedNameCache::EntryId QualifiedNameCache::get(const Cursor& c)
+{
+  LibClang& api = *m_api;
+
+  // climb until a cached scope or the translation unit
+  std::vector<CXCursor> chain;
+  CXCursor current = api.clang_getCanonicalCursor(c);
+  EntryId parent = NoEntry;
+
+  for (;;)
+  {
+    auto it = m_ids.find(CursorKey(current));
+
+    if (it != m_ids.end())
+    {
+      parent = it->second;
+      break;
+    }
+
+    chain.push_back(current);
+
+    CXCursor semantic_parent = api.clang_getCursorSemanticParent(current);
+
+    while (!api.clang_Cursor_isNull(semantic_parent) && is_transparent_context(semantic_parent.kind))
+      semantic_parent = api.clang_getCursorSemanticParent(semantic_parent);
+
+    if (api.clang_Cursor_isNull(semantic_parent) || !api.clang_isDeclaration(semantic_parent.kind))
+      break;
+
+    current = api.clang_getCanonicalCursor(semantic_parent);
+  }
+
+  // build the names top-down
+  for (auto it = chain.rbegin(); it != chain.rend(); ++it)
+    parent = insert(*it, parent);
+
+  return parent;
+}
+
+/**
+ * \brief returns the entry of a declaration if it is in the cache
+ * \return the entry, or NoEntry
+ */
+QualifiedNameCache::EntryId QualifiedNameCache::find(const Cursor& c) const
+{
+  auto it = m_ids.find(CursorKey(m_api->clang_getCanonicalCursor(c)));
+  return it != m_ids.end() ? it->second : NoEntry;
+}
+
+QualifiedNameCache::EntryId QualifiedNameCache::insert(const CXCursor& canonical, EntryId parent)
+{
+  LibClang& api = *m_api;
+
+  CXString spelling = api.clang_getCursorSpelling(canonical);
+  StringView name{ api.clang_getCString(spelling) };
+
+  // named like in the qualified names printed by clang
+  if (name.empty() && canonical.kind == CXCursor_Namespace)
+    name = StringView("(anonymous namespace)");
+
+  Entry e;
+  e.cursor = canonical;
+  e.parent = parent;
+  e.name = m_strings.intern(name);
+
+  if (parent == NoEntry)
+  {
+    e.qualified_name = e.name;
+    e.ancestors_offset = static_cast<uint32_t>(m_ancestors.size());
+    e.depth = 0;
+  }
+  else
+  {
+    const Entry& p = m_entries[parent];
+
+    StringView parent_name = m_strings.get(p.qualified_name);
+    std::string qualified_name;
+    qualified_name.reserve(parent_name.size() + 2 + name.size());
+    qualified_name.append(parent_name.data(), parent_name.size());
+    qualified_name += "::";
+    qualified_name.append(name.data(), name.size());
+    e.qualified_name = m_strings.intern(qualified_name);
+
+    // the ancestors of an entry are those of its parent followed by the parent
+    e.ancestors_offset = static_cast<uint32_t>(m_ancestors.size());
+    e.depth = p.depth + 1;
+    const uint32_t parent_offset = p.ancestors_offset;
+    const uint32_t parent_depth = p.depth;
+
+    m_ancestors.reserve(m_ancestors.size() + parent_depth + 1);
+
+    for (uint32_t i(0); i < parent_depth; ++i)
+      m_ancestors.push_back(m_ancestors[parent_offset + i]);
+
+    m_ancestors.push_back(parent);
+  }
+
+  api.clang_disposeString(spelling);
+
+  auto id = static_cast<EntryId>(m_entries.size());
+  m_entries.push_back(e);
+  m_ids[CursorKey(canonical)] = id;
+  return id;
+}
+
+} // namespace libclang
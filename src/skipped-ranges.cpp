@@ -0,0 +1,85 @@
+// Copyright (C) 2023 Vincent Chambrin
+// This file is part of the 'libclang-utils' project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include "libclang-utils/skipped-ranges.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+namespace libclang
+{
+
+static bool operator<(const SkippedRange& lhs, const SkippedRange& rhs)
+{
+  return lhs.file < rhs.file || (lhs.file == rhs.file && lhs.begin < rhs.begin);
+}
+
+/**
+ * \brief constructs the list from a libclang range list
+ *
+ * The libclang list is not disposed by this function.
+ */
+SkippedRanges::SkippedRanges(LibClang& api, const CXSourceRangeList& list)
+{
+  ranges.reserve(list.count);
+
+  std::unordered_map<CXFile, uint32_t> file_ids;
+
+  for (unsigned i(0); i < list.count; ++i)
+  {
+    CXFile file = nullptr;
+    SkippedRange r;
+
+    api.clang_getSpellingLocation(api.clang_getRangeStart(list.ranges[i]), &file, nullptr, nullptr, &r.begin);
+    api.clang_getSpellingLocation(api.clang_getRangeEnd(list.ranges[i]), nullptr, nullptr, nullptr, &r.end);
+
+    auto it = file_ids.find(file);
+
+    if (it == file_ids.end())
+    {
+      it = file_ids.emplace(file, static_cast<uint32_t>(files.size())).first;
+      files.push_back(file);
+    }
+
+    r.file = it->second;
+    ranges.push_back(r);
+  }
+
+  std::sort(ranges.begin(), ranges.end());
+}
+
+/**
+ * \brief returns the id of a file
+ * \return the id or -1 if no range belongs to this file
+ */
+int SkippedRanges::fileId(CXFile file) const
+{
+  auto it = std::find(files.begin(), files.end(), file);
+  return it != files.end() ? static_cast<int>(std::distance(files.begin(), it)) : -1;
+}
+
+/**
+ * \brief searches for the skipped range containing an offset
+ * \param file    the file id
+ * \param offset  the offset in the file
+ * \return a pointer to the range, or nullptr if the offset is not in a skipped range
+ *
+ * This function has logarithmic complexity.
+ */
+const SkippedRange* SkippedRanges::find(uint32_t file, unsigned offset) const
+{
+  SkippedRange key{ file, offset, offset };
+
+  // first range that starts after the offset
+  auto it = std::upper_bound(ranges.begin(), ranges.end(), key);
+
+  if (it == ranges.begin())
+    return nullptr;
+
+  --it;
+
+  return (it->file == file && offset < it->end) ? &(*it) : nullptr;
+}
+
+} // namespace libclang
@@ -0,0 +1,181 @@
+// Copyright (C) 2023 Vincent Chambrin
+// This file is part of the 'libclang-utils' project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include "libclang-utils/snapshot-diff.h"
+
+#include "libclang-utils/hash.h"
+
+#include <unordered_map>
+
+namespace libclang
+{
+
+namespace
+{
+
+// kinds whose declarations are not local to a function
+bool is_scope(CXCursorKind k)
+{
+  switch (k)
+  {
+  case CXCursor_Namespace:
+  case CXCursor_StructDecl:
+  case CXCursor_ClassDecl:
+  case CXCursor_UnionDecl:
+  case CXCursor_EnumDecl:
+  case CXCursor_ClassTemplate:
+  case CXCursor_ClassTemplatePartialSpecialization:
+  case CXCursor_LinkageSpec:
+    return true;
+  default:
+    return false;
+  }
+}
+
+struct DigestKey
+{
+  StringView usr;
+  CXCursorKind kind;
+  uint32_t occurrence;
+};
+
+bool operator==(const DigestKey& lhs, const DigestKey& rhs)
+{
+  return lhs.kind == rhs.kind && lhs.occurrence == rhs.occurrence && lhs.usr == rhs.usr;
+}
+
+struct DigestKeyHash
+{
+  size_t operator()(const DigestKey& key) const noexcept
+  {
+    uint64_t h = hash64(key.usr);
+    h = hashCombine(h, static_cast<uint64_t>(key.kind));
+    return static_cast<size_t>(hashCombine(h, key.occurrence));
+  }
+};
+
+// keys are (usr, kind, n) where n counts the previous entries with the same
+// usr and kind, e.g. a function declared before being defined
+std::vector<DigestKey> make_keys(const DeclarationDigest& digest)
+{
+  std::vector<DigestKey> keys;
+  keys.reserve(digest.size());
+
+  std::unordered_map<uint64_t, uint32_t> counts;
+
+  for (size_t i(0); i < digest.size(); ++i)
+  {
+    const DeclarationDigest::Entry& e = digest.entries[i];
+    uint32_t& count = counts[hashCombine(e.usr, static_cast<uint64_t>(e.kind))];
+    keys.push_back(DigestKey{ digest.usr(i), e.kind, count++ });
+  }
+
+  return keys;
+}
+
+} // namespace
+
+const uint32_t DeclarationChange::NoEntry;
+
+/**
+ * \brief computes the digest of the declarations of a file
+ * \param snapshot  a snapshot of the translation unit
+ * \param file      the id of the file in the file table of the snapshot
+ *
+ * Declarations are listed in the order of the snapshot; those without a
+ * USR are ignored.
+ * The translation unit must still be alive.
+ */
+DeclarationDigest::DeclarationDigest(const AstSnapshot& snapshot, FileTable::Id file)
+{
+  if (snapshot.empty())
+    return;
+
+  LibClang& api = *snapshot.api;
+  std::vector<uint64_t> hashes = structuralHashes(snapshot);
+
+  // whether the declarations whose parent is the node are recorded
+  std::vector<bool> recorded_scopes(snapshot.size(), false);
+  recorded_scopes[snapshot.root()] = true;
+
+  for (AstSnapshot::NodeId n(1); n < snapshot.size(); ++n)
+  {
+    CXCursorKind k = snapshot.kind(n);
+
+    if (!recorded_scopes[snapshot.parent(n)] || !api.clang_isDeclaration(k) || snapshot.file(n) != file)
+      continue;
+
+    recorded_scopes[n] = is_scope(k);
+
+    CXString usr = api.clang_getCursorUSR(snapshot.cursors[n]);
+    StringView str{ api.clang_getCString(usr) };
+
+    if (!str.empty())
+    {
+      Entry e;
+      e.usr = usrs.intern(str);
+      e.kind = k;
+      e.hash = hashes[n];
+      e.begin = snapshot.beginOffset(n);
+      e.end = snapshot.endOffset(n);
+      entries.push_back(e);
+    }
+
+    api.clang_disposeString(usr);
+  }
+}
+
+/**
+ * \brief computes the changes between two digests of the same file
+ *
+ * Declarations are matched by USR and kind; a declaration is changed if
+ * its structural hash differs, and moved if only its begin or end offset
+ * differs.
+ * As the hash of a declaration depends on its members, changing a member
+ * also reports a change of the enclosing class or namespace.
+ *
+ * Removed declarations are listed first, in the order of \a before,
+ * followed by added, changed and moved declarations in the order of
+ * \a after.
+ */
+std::vector<DeclarationChange> diff(const DeclarationDigest& before, const DeclarationDigest& after)
+{
+  std::vector<DigestKey> before_keys = make_keys(before);
+  std::vector<DigestKey> after_keys = make_keys(after);
+
+  std::unordered_map<DigestKey, uint32_t, DigestKeyHash> after_index;
+  after_index.reserve(after_keys.size());
+
+  for (uint32_t i(0); i < after_keys.size(); ++i)
+    after_index[after_keys[i]] = i;
+
+  std::vector<uint32_t> matches(after.size(), DeclarationChange::NoEntry);
+  std::vector<DeclarationChange> result;
+
+  for (uint32_t i(0); i < before_keys.size(); ++i)
+  {
+    auto it = after_index.find(before_keys[i]);
+
+    if (it == after_index.end())
+      result.push_back(DeclarationChange{ DeclarationChange::Removed, i, DeclarationChange::NoEntry });
+    else
+      matches[it->second] = i;
+  }
+
+  for (uint32_t i(0); i < after.size(); ++i)
+  {
+    uint32_t j = matches[i];
+
+    if (j == DeclarationChange::NoEntry)
+      result.push_back(DeclarationChange{ DeclarationChange::Added, DeclarationChange::NoEntry, i });
+    else if (before.entries[j].hash != after.entries[i].hash)
+      result.push_back(DeclarationChange{ DeclarationChange::Changed, j, i });
+    else if (before.entries[j].begin != after.entries[i].begin || before.entries[j].end != after.entries[i].end)
+      result.push_back(DeclarationChange{ DeclarationChange::Moved, j, i });
+  }
+
+  return result;
+}
+
+} // namespace libclang
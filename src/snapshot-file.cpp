@@ -0,0 +1,434 @@
+// Copyright (C) 2023 Vincent Chambrin
+// This file is part of the 'libclang-utils' project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include "libclang-utils/snapshot-file.h"
+
+#include "libclang-utils/ast-snapshot.h"
+#include "libclang-utils/string-table.h"
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#if defined(_WIN32)
+#  define WIN32_LEAN_AND_MEAN
+#  define NOMINMAX
+#  include <windows.h>
+#else
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+namespace libclang
+{
+
+namespace
+{
+
+const char SnapshotMagic[8] = { 'L', 'C', 'U', 'S', 'N', 'A', 'P', '\0' };
+const uint32_t ByteOrderMark = 0x01020304;
+
+class SnapshotWriter
+{
+public:
+  std::vector<char> buffer;
+  std::vector<SnapshotFileSection> sections;
+
+  void align()
+  {
+    buffer.resize((buffer.size() + 7) & ~size_t(7), '\0');
+  }
+
+  void write(const void* data, size_t size)
+  {
+    const char* bytes = static_cast<const char*>(data);
+    buffer.insert(buffer.end(), bytes, bytes + size);
+  }
+
+  void beginSection(SnapshotSection id)
+  {
+    align();
+    SnapshotFileSection s;
+    s.id = static_cast<uint32_t>(id);
+    s.reserved = 0;
+    s.offset = buffer.size();
+    s.size = 0;
+    sections.push_back(s);
+  }
+
+  void endSection()
+  {
+    sections.back().size = buffer.size() - sections.back().offset;
+  }
+
+  template<typename T>
+  void writeSection(SnapshotSection id, const std::vector<T>& values)
+  {
+    static_assert(sizeof(T) == 4, "node sections must contain 32-bit integers");
+    beginSection(id);
+    write(values.data(), values.size() * sizeof(T));
+    endSection();
+  }
+
+  void writeStrings(SnapshotSection id, const StringTable& table)
+  {
+    beginSection(id);
+
+    auto count = static_cast<uint32_t>(table.size());
+    write(&count, sizeof(count));
+
+    std::vector<uint32_t> offsets;
+    offsets.reserve(table.size() + 1);
+    uint32_t offset = 0;
+
+    for (StringTable::Id i(0); i < table.size(); ++i)
+    {
+      offsets.push_back(offset);
+      offset += static_cast<uint32_t>(table.get(i).size() + 1);
+    }
+
+    offsets.push_back(offset);
+    write(offsets.data(), offsets.size() * sizeof(uint32_t));
+
+    for (StringTable::Id i(0); i < table.size(); ++i)
+      write(table.c_str(i), table.get(i).size() + 1);
+
+    endSection();
+  }
+};
+
+StringTable::Id intern(StringTable& table, LibClang& api, CXString str)
+{
+  StringTable::Id id = table.intern(StringView(api.clang_getCString(str)));
+  api.clang_disposeString(str);
+  return id;
+}
+
+} // namespace
+
+/**
+ * \brief saves a snapshot to a file
+ * \param snapshot  the snapshot
+ * \param path      the path of the file
+ *
+ * In addition to the node arrays, the spelling of each node and the USR
+ * of each declaration are saved in string tables.
+ * As they are retrieved from the cursors of the snapshot, the translation
+ * unit must still be alive.
+ *
+ * Throws std::runtime_error if the file cannot be written.
+ */
+void saveSnapshot(const AstSnapshot& snapshot, const std::string& path)
+{
+  LibClang& api = *snapshot.api;
+
+  StringTable spelling_strings;
+  StringTable usr_strings;
+  StringTable file_name_strings;
+  std::vector<uint32_t> spellings;
+  std::vector<uint32_t> usrs;
+  std::vector<SnapshotFileEntry> files;
+
+  spellings.reserve(snapshot.size());
+  usrs.reserve(snapshot.size());
+
+  for (size_t i(0); i < snapshot.size(); ++i)
+  {
+    CXCursor c = snapshot.cursors[i];
+    spellings.push_back(intern(spelling_strings, api, api.clang_getCursorSpelling(c)));
+    usrs.push_back(api.clang_isDeclaration(snapshot.kinds[i]) ? intern(usr_strings, api, api.clang_getCursorUSR(c)) : 0);
+  }
+
+  for (FileTable::Id i(0); i < snapshot.file_table.size(); ++i)
+  {
+    SnapshotFileEntry entry;
+    entry.name = file_name_strings.intern(snapshot.file_table.name(i));
+    entry.depth = snapshot.file_table.depth(i);
+    entry.size = snapshot.file_table.fileSize(i);
+    files.push_back(entry);
+  }
+
+  SnapshotWriter writer;
+
+  SnapshotFileHeader header;
+  std::memcpy(header.magic, SnapshotMagic, sizeof(SnapshotMagic));
+  header.version = SnapshotFile::Version;
+  header.byte_order = ByteOrderMark;
+  header.node_count = static_cast<uint32_t>(snapshot.size());
+  header.file_count = static_cast<uint32_t>(files.size());
+  // sections are numbered from 1 to FileNameStrings
+  header.section_count = static_cast<uint32_t>(SnapshotSection::FileNameStrings);
+  header.reserved = 0;
+
+  // the header and section list are rewritten once the sections are known
+  writer.buffer.resize(sizeof(SnapshotFileHeader) + header.section_count * sizeof(SnapshotFileSection));
+
+  std::vector<int32_t> kinds{ snapshot.kinds.begin(), snapshot.kinds.end() };
+  writer.writeSection(SnapshotSection::Kinds, kinds);
+  writer.writeSection(SnapshotSection::Parents, snapshot.parents);
+  writer.writeSection(SnapshotSection::FirstChildren, snapshot.first_children);
+  writer.writeSection(SnapshotSection::NextSiblings, snapshot.next_siblings);
+  writer.writeSection(SnapshotSection::SubtreeEnds, snapshot.subtree_ends);
+  writer.writeSection(SnapshotSection::ChildOffsets, snapshot.child_offsets);
+  writer.writeSection(SnapshotSection::Children, snapshot.children);
+  writer.writeSection(SnapshotSection::ChildIndices, snapshot.child_indices);
+  writer.writeSection(SnapshotSection::BeginOffsets, snapshot.begin_offsets);
+  writer.writeSection(SnapshotSection::EndOffsets, snapshot.end_offsets);
+  writer.writeSection(SnapshotSection::FileIds, snapshot.file_ids);
+  writer.writeSection(SnapshotSection::Spellings, spellings);
+  writer.writeSection(SnapshotSection::Usrs, usrs);
+
+  writer.beginSection(SnapshotSection::Files);
+  writer.write(files.data(), files.size() * sizeof(SnapshotFileEntry));
+  writer.endSection();
+
+  writer.writeStrings(SnapshotSection::SpellingStrings, spelling_strings);
+  writer.writeStrings(SnapshotSection::UsrStrings, usr_strings);
+  writer.writeStrings(SnapshotSection::FileNameStrings, file_name_strings);
+
+  std::memcpy(writer.buffer.data(), &header, sizeof(header));
+  std::memcpy(writer.buffer.data() + sizeof(header), writer.sections.data(), writer.sections.size() * sizeof(SnapshotFileSection));
+
+  std::ofstream stream{ path, std::ios::binary | std::ios::trunc };
+
+  if (!stream.write(writer.buffer.data(), writer.buffer.size()))
+    throw std::runtime_error{ "could not write snapshot file '" + path + "'" };
+}
+
+const SnapshotFile::NodeId SnapshotFile::NoNode;
+const uint32_t SnapshotFile::NoFile;
+const uint32_t SnapshotFile::Version;
+
+/**
+ * \brief maps a snapshot file in memory
+ */
+SnapshotFile::SnapshotFile(const std::string& path)
+{
+  try
+  {
+    open(path);
+    map();
+  }
+  catch (...)
+  {
+    close();
+    throw;
+  }
+}
+
+SnapshotFile::SnapshotFile(SnapshotFile&& other) noexcept
+{
+  *this = std::move(other);
+}
+
+SnapshotFile::~SnapshotFile()
+{
+  close();
+}
+
+SnapshotFile& SnapshotFile::operator=(SnapshotFile&& other) noexcept
+{
+  if (this != &other)
+  {
+    close();
+
+    m_data = other.m_data;
+    m_size = other.m_size;
+    m_file_handle = other.m_file_handle;
+    m_mapping_handle = other.m_mapping_handle;
+
+    other.m_data = nullptr;
+    other.m_file_handle = nullptr;
+    other.m_mapping_handle = nullptr;
+    other.close();
+
+    // the file was validated when it was opened, this cannot throw
+    if (m_data)
+      map();
+  }
+
+  return *this;
+}
+
+/**
+ * \brief unmaps the file
+ */
+void SnapshotFile::close()
+{
+#if defined(_WIN32)
+  if (m_data)
+    UnmapViewOfFile(m_data);
+  if (m_mapping_handle)
+    CloseHandle(m_mapping_handle);
+  if (m_file_handle)
+    CloseHandle(m_file_handle);
+#else
+  if (m_data)
+    munmap(const_cast<char*>(m_data), m_size);
+#endif
+
+  m_data = nullptr;
+  m_size = 0;
+  m_file_handle = nullptr;
+  m_mapping_handle = nullptr;
+  m_header = nullptr;
+  m_kinds = nullptr;
+  m_parents = m_first_children = m_next_siblings = m_subtree_ends = nullptr;
+  m_child_offsets = m_children = m_child_indices = nullptr;
+  m_begin_offsets = m_end_offsets = m_file_ids = nullptr;
+  m_spellings = m_usrs = nullptr;
+  m_files = nullptr;
+  m_spelling_strings = m_usr_strings = m_file_name_strings = SnapshotStrings();
+}
+
+void SnapshotFile::open(const std::string& path)
+{
+#if defined(_WIN32)
+  HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+  if (file == INVALID_HANDLE_VALUE)
+    throw std::runtime_error{ "could not open snapshot file '" + path + "'" };
+
+  m_file_handle = file;
+
+  LARGE_INTEGER size;
+
+  if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+    throw std::runtime_error{ "invalid snapshot file '" + path + "'" };
+
+  m_mapping_handle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+  if (!m_mapping_handle)
+    throw std::runtime_error{ "could not map snapshot file '" + path + "'" };
+
+  m_data = static_cast<const char*>(MapViewOfFile(m_mapping_handle, FILE_MAP_READ, 0, 0, 0));
+  m_size = static_cast<size_t>(size.QuadPart);
+#else
+  int fd = ::open(path.c_str(), O_RDONLY);
+
+  if (fd == -1)
+    throw std::runtime_error{ "could not open snapshot file '" + path + "'" };
+
+  struct stat st;
+
+  if (fstat(fd, &st) != 0 || st.st_size == 0)
+  {
+    ::close(fd);
+    throw std::runtime_error{ "invalid snapshot file '" + path + "'" };
+  }
+
+  void* addr = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+
+  if (addr != MAP_FAILED)
+  {
+    m_data = static_cast<const char*>(addr);
+    m_size = static_cast<size_t>(st.st_size);
+  }
+#endif
+
+  if (!m_data)
+    throw std::runtime_error{ "could not map snapshot file '" + path + "'" };
+}
+
+void SnapshotFile::map()
+{
+  if (m_size < sizeof(SnapshotFileHeader))
+    throw std::runtime_error{ "invalid snapshot file: truncated header" };
+
+  m_header = reinterpret_cast<const SnapshotFileHeader*>(m_data);
+
+  if (std::memcmp(m_header->magic, SnapshotMagic, sizeof(SnapshotMagic)) != 0)
+    throw std::runtime_error{ "invalid snapshot file: bad magic number" };
+
+  if (m_header->byte_order != ByteOrderMark)
+    throw std::runtime_error{ "invalid snapshot file: unsupported byte order" };
+
+  if (m_header->version != Version)
+    throw std::runtime_error{ "unsupported snapshot file version " + std::to_string(m_header->version) };
+
+  if (sizeof(SnapshotFileHeader) + uint64_t(m_header->section_count) * sizeof(SnapshotFileSection) > m_size)
+    throw std::runtime_error{ "invalid snapshot file: truncated section list" };
+
+  const uint64_t n = m_header->node_count;
+  const uint64_t node_section_size = n * sizeof(uint32_t);
+
+  m_kinds = static_cast<const int32_t*>(section(SnapshotSection::Kinds, node_section_size));
+  m_parents = static_cast<const uint32_t*>(section(SnapshotSection::Parents, node_section_size));
+  m_first_children = static_cast<const uint32_t*>(section(SnapshotSection::FirstChildren, node_section_size));
+  m_next_siblings = static_cast<const uint32_t*>(section(SnapshotSection::NextSiblings, node_section_size));
+  m_subtree_ends = static_cast<const uint32_t*>(section(SnapshotSection::SubtreeEnds, node_section_size));
+  m_child_offsets = static_cast<const uint32_t*>(section(SnapshotSection::ChildOffsets, node_section_size + sizeof(uint32_t)));
+  m_children = static_cast<const uint32_t*>(section(SnapshotSection::Children, n > 0 ? node_section_size - sizeof(uint32_t) : 0));
+  m_child_indices = static_cast<const uint32_t*>(section(SnapshotSection::ChildIndices, node_section_size));
+  m_begin_offsets = static_cast<const uint32_t*>(section(SnapshotSection::BeginOffsets, node_section_size));
+  m_end_offsets = static_cast<const uint32_t*>(section(SnapshotSection::EndOffsets, node_section_size));
+  m_file_ids = static_cast<const uint32_t*>(section(SnapshotSection::FileIds, node_section_size));
+  m_spellings = static_cast<const uint32_t*>(section(SnapshotSection::Spellings, node_section_size));
+  m_usrs = static_cast<const uint32_t*>(section(SnapshotSection::Usrs, node_section_size));
+  m_files = static_cast<const SnapshotFileEntry*>(section(SnapshotSection::Files, uint64_t(m_header->file_count) * sizeof(SnapshotFileEntry)));
+
+  m_spelling_strings = strings(SnapshotSection::SpellingStrings);
+  m_usr_strings = strings(SnapshotSection::UsrStrings);
+  m_file_name_strings = strings(SnapshotSection::FileNameStrings);
+}
+
+const void* SnapshotFile::section(SnapshotSection id, uint64_t expected_size) const
+{
+  auto* sections = reinterpret_cast<const SnapshotFileSection*>(m_data + sizeof(SnapshotFileHeader));
+
+  for (uint32_t i(0); i < m_header->section_count; ++i)
+  {
+    const SnapshotFileSection& s = sections[i];
+
+    if (s.id != static_cast<uint32_t>(id))
+      continue;
+
+    if (s.offset % 8 != 0 || s.offset > m_size || s.size > m_size - s.offset)
+      throw std::runtime_error{ "invalid snapshot file: section out of bounds" };
+
+    if (expected_size != uint64_t(-1) && s.size != expected_size)
+      throw std::runtime_error{ "invalid snapshot file: bad section size" };
+
+    return m_data + s.offset;
+  }
+
+  throw std::runtime_error{ "invalid snapshot file: missing section " + std::to_string(static_cast<uint32_t>(id)) };
+}
+
+SnapshotStrings SnapshotFile::strings(SnapshotSection id) const
+{
+  auto* data = static_cast<const char*>(section(id, uint64_t(-1)));
+  auto* sections = reinterpret_cast<const SnapshotFileSection*>(m_data + sizeof(SnapshotFileHeader));
+  uint64_t size = 0;
+
+  for (uint32_t i(0); i < m_header->section_count; ++i)
+  {
+    if (sections[i].id == static_cast<uint32_t>(id))
+      size = sections[i].size;
+  }
+
+  uint32_t count = 0;
+
+  if (size >= sizeof(uint32_t))
+    std::memcpy(&count, data, sizeof(uint32_t));
+
+  const uint64_t header_size = (uint64_t(count) + 2) * sizeof(uint32_t);
+
+  if (count == 0 || size < header_size)
+    throw std::runtime_error{ "invalid snapshot file: bad string table" };
+
+  auto* offsets = reinterpret_cast<const uint32_t*>(data + sizeof(uint32_t));
+
+  if (offsets[count] > size - header_size)
+    throw std::runtime_error{ "invalid snapshot file: bad string table" };
+
+  return SnapshotStrings(offsets, data + header_size, count);
+}
+
+} // namespace libclang
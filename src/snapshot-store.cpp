@@ -0,0 +1,142 @@
+// Copyright (C) 2023 Vincent Chambrin
+// This file is part of the 'libclang-utils' project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include "libclang-utils/snapshot-store.h"
+
+#include "libclang-utils/hash.h"
+#include "libclang-utils/merkle-hash.h"
+
+namespace libclang
+{
+
+size_t SnapshotStore::FragmentKeyHash::operator()(const FragmentKey& key) const noexcept
+{
+  uint64_t h = hashCombine(key.content_hash, key.structural_hash);
+  h = hashCombine(h, key.size);
+
+  for (unsigned long long part : key.unique_id.data)
+    h = hashCombine(h, part);
+
+  return static_cast<size_t>(h);
+}
+
+bool SnapshotStore::FragmentKeyEqual::operator()(const FragmentKey& lhs, const FragmentKey& rhs) const noexcept
+{
+  return details::FileUniqueIDEqual()(lhs.unique_id, rhs.unique_id)
+    && lhs.content_hash == rhs.content_hash
+    && lhs.structural_hash == rhs.structural_hash
+    && lhs.size == rhs.size;
+}
+
+/**
+ * \brief adds the snapshot of a translation unit to the store
+ * \return the id of the translation unit in the store
+ *
+ * The translation unit must still be alive.
+ */
+SnapshotStore::UnitId SnapshotStore::add(const AstSnapshot& snapshot)
+{
+  Unit unit;
+  unit.name = 0;
+
+  if (snapshot.empty())
+  {
+    m_units.push_back(std::move(unit));
+    return static_cast<UnitId>(m_units.size() - 1);
+  }
+
+  LibClang& api = *snapshot.api;
+  CXTranslationUnit tu = api.clang_Cursor_getTranslationUnit(snapshot.cursors[0]);
+
+  CXString tu_name = api.clang_getTranslationUnitSpelling(tu);
+  unit.name = m_strings.intern(StringView(api.clang_getCString(tu_name)));
+  api.clang_disposeString(tu_name);
+
+  std::vector<uint64_t> hashes = structuralHashes(snapshot);
+
+  std::vector<uint64_t> content_hashes(snapshot.file_table.size());
+
+  for (FileTable::Id f(0); f < snapshot.file_table.size(); ++f)
+  {
+    size_t size = 0;
+    const char* data = api.clang_getFileContents(tu, snapshot.file_table.file(f), &size);
+    content_hashes[f] = data ? hash64(data, size) : 0;
+  }
+
+  const AstSnapshot::NodeId root = snapshot.root();
+  const size_t nb_top_level = snapshot.childCount(root);
+  size_t i = 0;
+
+  while (i < nb_top_level)
+  {
+    // group consecutive top-level nodes of the same file
+    const FileTable::Id file = snapshot.file(snapshot.childAt(root, i));
+    size_t j = i;
+    uint64_t structural_hash = 0;
+
+    while (j < nb_top_level && snapshot.file(snapshot.childAt(root, j)) == file)
+      structural_hash = hashCombine(structural_hash, hashes[snapshot.childAt(root, j++)]);
+
+    const AstSnapshot::NodeId first = snapshot.childAt(root, i);
+    const AstSnapshot::NodeId last = snapshot.subtreeEnd(snapshot.childAt(root, j - 1));
+
+    FragmentKey key;
+    key.unique_id = file != FileTable::NoFile ? snapshot.file_table.at(file).unique_id : CXFileUniqueID{ { 0, 0, 0 } };
+    key.content_hash = file != FileTable::NoFile ? content_hashes[file] : 0;
+    key.structural_hash = structural_hash;
+    key.size = last - first;
+
+    m_referenced_nodes += key.size;
+
+    auto it = m_index.find(key);
+
+    if (it != m_index.end())
+    {
+      ++m_fragments[it->second].references;
+      unit.fragments.push_back(it->second);
+      i = j;
+      continue;
+    }
+
+    SnapshotFragment fragment;
+    fragment.unique_id = key.unique_id;
+    fragment.file_name = file != FileTable::NoFile ? m_strings.intern(snapshot.file_table.name(file)) : 0;
+    fragment.content_hash = key.content_hash;
+    fragment.structural_hash = key.structural_hash;
+    fragment.references = 1;
+
+    fragment.kinds.reserve(key.size);
+    fragment.parents.reserve(key.size);
+    fragment.begin_offsets.reserve(key.size);
+    fragment.end_offsets.reserve(key.size);
+    fragment.spellings.reserve(key.size);
+
+    for (AstSnapshot::NodeId n = first; n < last; ++n)
+    {
+      AstSnapshot::NodeId parent = snapshot.parent(n);
+
+      fragment.kinds.push_back(snapshot.kind(n));
+      fragment.parents.push_back(parent == root ? AstSnapshot::NoNode : parent - first);
+      fragment.begin_offsets.push_back(snapshot.beginOffset(n));
+      fragment.end_offsets.push_back(snapshot.endOffset(n));
+
+      CXString spelling = api.clang_getCursorSpelling(snapshot.cursors[n]);
+      fragment.spellings.push_back(m_strings.intern(StringView(api.clang_getCString(spelling))));
+      api.clang_disposeString(spelling);
+    }
+
+    auto id = static_cast<FragmentId>(m_fragments.size());
+    m_stored_nodes += fragment.size();
+    m_fragments.push_back(std::move(fragment));
+    m_index[key] = id;
+    unit.fragments.push_back(id);
+
+    i = j;
+  }
+
+  m_units.push_back(std::move(unit));
+  return static_cast<UnitId>(m_units.size() - 1);
+}
+
+} // namespace libclang
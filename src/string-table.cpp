@@ -0,0 +1,77 @@
+// Copyright (C) 2023 Vincent Chambrin
+// This file is part of the 'libclang-utils' project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include "libclang-utils/string-table.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace libclang
+{
+
+static const size_t StringTableChunkSize = 64 * 1024;
+
+/**
+ * \brief constructs a table containing only the empty string
+ */
+StringTable::StringTable()
+{
+  m_strings.push_back(StringView("", 0));
+  m_ids[m_strings.front()] = 0;
+}
+
+/**
+ * \brief adds a string to the table
+ * \param str  the string
+ * \return the id of the string
+ *
+ * If the string is already in the table, its existing id is returned.
+ */
+StringTable::Id StringTable::intern(StringView str)
+{
+  auto it = m_ids.find(str);
+
+  if (it != m_ids.end())
+    return it->second;
+
+  StringView stored{ store(str), str.size() };
+  Id id = static_cast<Id>(m_strings.size());
+  m_strings.push_back(stored);
+  m_ids[stored] = id;
+  return id;
+}
+
+/**
+ * \brief searches for a string in the table
+ * \return the id of the string, or 0 if the string isn't in the table
+ */
+StringTable::Id StringTable::find(StringView str) const
+{
+  auto it = m_ids.find(str);
+  return it != m_ids.end() ? it->second : 0;
+}
+
+const char* StringTable::store(StringView str)
+{
+  const size_t n = str.size() + 1;
+
+  if (m_chunks.empty() || m_chunk_capacity - m_chunk_used < n)
+  {
+    m_chunk_capacity = std::max(StringTableChunkSize, n);
+    m_chunks.emplace_back(new char[m_chunk_capacity]);
+    m_chunk_used = 0;
+  }
+
+  char* dest = m_chunks.back().get() + m_chunk_used;
+
+  if (str.size())
+    std::memcpy(dest, str.data(), str.size());
+
+  dest[str.size()] = '\0';
+  m_chunk_used += n;
+
+  return dest;
+}
+
+} // namespace libclang
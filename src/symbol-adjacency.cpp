@@ -0,0 +1,83 @@
+// Copyright (C) 2023 Vincent Chambrin
+// This file is part of the 'libclang-utils' project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include "libclang-utils/symbol-adjacency.h"
+
+#include <algorithm>
+
+namespace libclang
+{
+
+SymbolAdjacency::SymbolAdjacency()
+  : m_offsets{ 0 }
+{
+
+}
+
+/**
+ * \brief builds the adjacency lists from a list of edges
+ * \param sorted_edges  the edges, sorted and without duplicates
+ */
+SymbolAdjacency::SymbolAdjacency(const std::vector<SymbolEdge>& sorted_edges)
+  : m_offsets{ 0 }
+{
+  m_targets.reserve(sorted_edges.size());
+
+  for (const SymbolEdge& e : sorted_edges)
+  {
+    if (m_sources.empty() || m_sources.back() != e.from)
+    {
+      m_sources.push_back(e.from);
+      m_offsets.push_back(m_offsets.back());
+    }
+
+    m_targets.push_back(e.to);
+    ++m_offsets.back();
+  }
+}
+
+/**
+ * \brief returns the targets of a symbol
+ */
+ArrayView<SymbolKey> SymbolAdjacency::targets(SymbolKey from) const
+{
+  auto it = std::lower_bound(m_sources.begin(), m_sources.end(), from);
+
+  if (it == m_sources.end() || *it != from)
+    return ArrayView<SymbolKey>();
+
+  size_t i = static_cast<size_t>(std::distance(m_sources.begin(), it));
+  return ArrayView<SymbolKey>(m_targets.data() + m_offsets[i], m_offsets[i + 1] - m_offsets[i]);
+}
+
+namespace details
+{
+
+/**
+ * \brief sorts a list of edges and removes the duplicates
+ */
+void sort_edges(std::vector<SymbolEdge>& edges)
+{
+  std::sort(edges.begin(), edges.end());
+  edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+}
+
+/**
+ * \brief returns the sorted list of the reversed edges
+ */
+std::vector<SymbolEdge> reverse_edges(const std::vector<SymbolEdge>& edges)
+{
+  std::vector<SymbolEdge> result;
+  result.reserve(edges.size());
+
+  for (const SymbolEdge& e : edges)
+    result.push_back(SymbolEdge{ e.to, e.from });
+
+  std::sort(result.begin(), result.end());
+  return result;
+}
+
+} // namespace details
+
+} // namespace libclang
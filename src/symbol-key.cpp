@@ -0,0 +1,113 @@
+// Copyright (C) 2023 Vincent Chambrin
+// This file is part of the 'libclang-utils' project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include "libclang-utils/symbol-key.h"
+
+#include "libclang-utils/clang-string.h"
+#include "libclang-utils/hash.h"
+
+namespace libclang
+{
+
+/**
+ * \brief computes the key of a USR
+ *
+ * The empty USR gets the null key.
+ */
+SymbolKey symbolKey(StringView usr, uint64_t seed)
+{
+  SymbolKey key;
+
+  if (!usr.empty())
+  {
+    key.hash = hash64(usr, seed);
+
+    // 0 is reserved for the null key
+    if (key.hash == 0)
+      key.hash = 1;
+  }
+
+  return key;
+}
+
+/**
+ * \brief computes the key of the USR of a cursor
+ *
+ * The USR is hashed directly in the buffer returned by libclang, no
+ * std::string is created.
+ */
+SymbolKey symbolKey(const Cursor& c)
+{
+  ClangString usr{ *c.api, c.api->clang_getCursorUSR(c) };
+  return symbolKey(usr.view());
+}
+
+/**
+ * \brief returns the key of a USR, adding it to the table if needed
+ */
+SymbolKey SymbolKeyTable::insert(StringView usr)
+{
+  if (usr.empty())
+    return SymbolKey();
+
+  for (uint64_t seed(0);; ++seed)
+  {
+    SymbolKey key = symbolKey(usr, seed);
+    auto it = m_keys.find(key.hash);
+
+    if (it == m_keys.end())
+    {
+      m_keys[key.hash] = m_usrs.intern(usr);
+      return key;
+    }
+
+    if (m_usrs.get(it->second) == usr)
+      return key;
+
+    ++m_collisions;
+  }
+}
+
+/**
+ * \brief returns the key of the USR of a cursor, adding it to the table if needed
+ */
+SymbolKey SymbolKeyTable::insert(const Cursor& c)
+{
+  ClangString usr{ *c.api, c.api->clang_getCursorUSR(c) };
+  return insert(usr.view());
+}
+
+/**
+ * \brief returns the key of a USR
+ * \return the key, or the null key if the USR is not in the table
+ */
+SymbolKey SymbolKeyTable::find(StringView usr) const
+{
+  if (usr.empty())
+    return SymbolKey();
+
+  for (uint64_t seed(0);; ++seed)
+  {
+    SymbolKey key = symbolKey(usr, seed);
+    auto it = m_keys.find(key.hash);
+
+    if (it == m_keys.end())
+      return SymbolKey();
+
+    if (m_usrs.get(it->second) == usr)
+      return key;
+  }
+}
+
+/**
+ * \brief returns the USR associated with a key
+ * \return the USR, or an empty string if the key was not produced by this table
+ */
+StringView SymbolKeyTable::usr(SymbolKey key) const
+{
+  auto it = m_keys.find(key.hash);
+  return it != m_keys.end() ? m_usrs.get(it->second) : StringView();
+}
+
+} // namespace libclang
@@ -0,0 +1,299 @@
+// Copyright (C) 2023 Vincent Chambrin
+// This file is part of the 'libclang-utils' project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include "libclang-utils/template-index.h"
+
+#include "libclang-utils/clang-cursor.h"
+#include "libclang-utils/clang-source-range.h"
+#include "libclang-utils/clang-string.h"
+#include "libclang-utils/clang-translation-unit.h"
+#include "libclang-utils/cursor-key.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <unordered_set>
+
+namespace libclang
+{
+
+namespace
+{
+
+bool is_specialization_kind(CXCursorKind k)
+{
+  switch (k)
+  {
+  case CXCursor_StructDecl:
+  case CXCursor_ClassDecl:
+  case CXCursor_UnionDecl:
+  case CXCursor_FunctionDecl:
+  case CXCursor_CXXMethod:
+  case CXCursor_VarDecl:
+    return true;
+  default:
+    return false;
+  }
+}
+
+enum class SpecializationSyntax
+{
+  ExplicitSpecialization, // template<> struct Box<int> { };
+  ExplicitInstantiation, // template struct Box<int>;
+  ExternInstantiation, // extern template struct Box<int>;
+};
+
+bool skip_word(StringView text, size_t& pos, const char* word)
+{
+  size_t n = std::strlen(word);
+
+  if (text.size() - pos < n || std::memcmp(text.data() + pos, word, n) != 0)
+    return false;
+
+  pos += n;
+
+  while (pos < text.size() && std::isspace(static_cast<unsigned char>(text[pos])))
+    ++pos;
+
+  return true;
+}
+
+/*
+ * Specializations declared in the source are either explicit
+ * specializations or explicit instantiations; they are told apart by
+ * their leading tokens: "template" is followed by "<" only in the former.
+ */
+SpecializationSyntax specialization_syntax(LibClang& api, const CXCursor& c, details::FileContentsCache& contents)
+{
+  StringView text = details::range_text(api, api.clang_Cursor_getTranslationUnit(c), api.clang_getCursorExtent(c), contents);
+
+  size_t pos = 0;
+  bool is_extern = skip_word(text, pos, "extern");
+
+  if (!skip_word(text, pos, "template") || (pos < text.size() && text[pos] == '<'))
+    return SpecializationSyntax::ExplicitSpecialization;
+
+  return is_extern ? SpecializationSyntax::ExternInstantiation : SpecializationSyntax::ExplicitInstantiation;
+}
+
+} // namespace
+
+/**
+ * \brief builds the index of a translation unit
+ */
+TemplateIndex::TemplateIndex(const TranslationUnit& tu)
+  : m_unit_count(1)
+{
+  LibClang& api = *tu.api;
+
+  std::unordered_set<SymbolKey> explicit_specializations;
+  details::FileContentsCache contents;
+
+  // declarations that were already considered as instantiations
+  std::unordered_set<CursorKey> seen;
+
+  auto consider = [&](CXCursor d) {
+    CXCursorKind k = api.clang_getCursorKind(d);
+
+    if (!is_specialization_kind(k) || !seen.insert(CursorKey(d)).second)
+      return;
+
+    CXCursor primary = api.clang_getSpecializedCursorTemplate(d);
+
+    if (api.clang_Cursor_isNull(primary))
+      return;
+
+    SymbolKey specialization = symbolKey(Cursor(api, d));
+
+    if (specialization.isNull() || explicit_specializations.count(specialization) || m_rows.count(specialization))
+      return;
+
+    TemplateInstantiation inst;
+    inst.specialization = specialization;
+    inst.primary = symbolKey(Cursor(api, primary));
+    inst.first_argument = static_cast<uint32_t>(m_arguments.size());
+    inst.argument_count = 0;
+    inst.unit_count = 1;
+
+    int nb_args = api.clang_Cursor_getNumTemplateArguments(d);
+
+    for (int i(0); i < nb_args; ++i)
+    {
+      TemplateArgument arg;
+      arg.kind = api.clang_Cursor_getTemplateArgumentKind(d, i);
+      arg.type = 0;
+      arg.value = 0;
+
+      if (arg.kind == CXTemplateArgumentKind_Type)
+      {
+        ClangString str{ api, api.clang_getTypeSpelling(api.clang_Cursor_getTemplateArgumentType(d, i)) };
+        arg.type = m_strings.intern(str.view());
+      }
+      else if (arg.kind == CXTemplateArgumentKind_Integral)
+      {
+        arg.value = api.clang_Cursor_getTemplateArgumentValue(d, i);
+      }
+
+      m_arguments.push_back(arg);
+      ++inst.argument_count;
+    }
+
+    m_rows[specialization] = static_cast<uint32_t>(m_instantiations.size());
+    m_instantiations.push_back(inst);
+  };
+
+  tu.getCursor().visitRecursively([&](const Cursor& c, const Cursor&) -> VisitResult {
+    CXCursorKind k = api.clang_getCursorKind(c);
+    bool is_decl = api.clang_isDeclaration(k);
+
+    if (!is_decl && !api.clang_isExpression(k))
+      return VisitResult::Recurse;
+
+    if (k == CXCursor_ClassTemplatePartialSpecialization)
+    {
+      CXCursor primary = api.clang_getSpecializedCursorTemplate(c);
+      m_partial.push_back(SymbolEdge{ symbolKey(Cursor(api, primary)), symbolKey(c) });
+    }
+    else if (is_decl && is_specialization_kind(k))
+    {
+      CXCursor primary = api.clang_getSpecializedCursorTemplate(c);
+
+      if (!api.clang_Cursor_isNull(primary))
+      {
+        SymbolKey specialization = symbolKey(c);
+        SpecializationSyntax syntax = specialization_syntax(api, c, contents);
+
+        if (syntax == SpecializationSyntax::ExplicitSpecialization)
+        {
+          m_explicit.push_back(SymbolEdge{ symbolKey(Cursor(api, primary)), specialization });
+          explicit_specializations.insert(specialization);
+        }
+        else
+        {
+          m_explicit_instantiations.push_back(SymbolEdge{ symbolKey(Cursor(api, primary)), specialization });
+
+          // an extern template suppresses the instantiation in this unit
+          if (syntax == SpecializationSyntax::ExternInstantiation)
+            return VisitResult::SkipSubtree;
+        }
+      }
+    }
+
+    consider(api.clang_getTypeDeclaration(api.clang_getCursorType(c)));
+
+    if (!is_decl)
+      consider(api.clang_getCursorReferenced(c));
+
+    return VisitResult::Recurse;
+    });
+
+  build();
+}
+
+/**
+ * \brief returns the instantiation of a specialization
+ * \return a pointer to the instantiation, or nullptr if the specialization isn't in the index
+ */
+const TemplateInstantiation* TemplateIndex::findInstantiation(SymbolKey specialization) const
+{
+  auto it = m_rows.find(specialization);
+  return it != m_rows.end() ? &m_instantiations[it->second] : nullptr;
+}
+
+/**
+ * \brief returns the instantiations used in at least \a min_units translation units
+ *
+ * Instantiations are sorted by decreasing unit count.
+ */
+std::vector<const TemplateInstantiation*> TemplateIndex::duplicatedInstantiations(uint32_t min_units) const
+{
+  std::vector<const TemplateInstantiation*> result;
+
+  for (const TemplateInstantiation& inst : m_instantiations)
+  {
+    if (inst.unit_count >= min_units)
+      result.push_back(&inst);
+  }
+
+  std::stable_sort(result.begin(), result.end(), [](const TemplateInstantiation* a, const TemplateInstantiation* b) {
+    return a->unit_count > b->unit_count;
+    });
+
+  return result;
+}
+
+/**
+ * \brief adds the content of another index to this one
+ *
+ * The unit counts of the instantiations found in both indexes are summed.
+ */
+void TemplateIndex::merge(const TemplateIndex& other)
+{
+  merge(std::vector<const TemplateIndex*>{ &other });
+}
+
+/**
+ * \brief adds the content of several indexes to this one
+ *
+ * The index is rebuilt once, prefer this overload to merging the indexes
+ * one at a time.
+ */
+void TemplateIndex::merge(const std::vector<const TemplateIndex*>& others)
+{
+  for (const TemplateIndex* other : others)
+  {
+    m_unit_count += other->m_unit_count;
+    m_explicit.insert(m_explicit.end(), other->m_explicit.begin(), other->m_explicit.end());
+    m_partial.insert(m_partial.end(), other->m_partial.begin(), other->m_partial.end());
+    m_explicit_instantiations.insert(m_explicit_instantiations.end(), other->m_explicit_instantiations.begin(), other->m_explicit_instantiations.end());
+
+    for (const TemplateInstantiation& inst : other->m_instantiations)
+    {
+      auto it = m_rows.find(inst.specialization);
+
+      if (it != m_rows.end())
+      {
+        m_instantiations[it->second].unit_count += inst.unit_count;
+        continue;
+      }
+
+      TemplateInstantiation copy = inst;
+      copy.first_argument = static_cast<uint32_t>(m_arguments.size());
+
+      for (const TemplateArgument& arg : other->arguments(inst))
+      {
+        TemplateArgument a = arg;
+        a.type = m_strings.intern(other->string(arg.type));
+        m_arguments.push_back(a);
+      }
+
+      m_rows[copy.specialization] = static_cast<uint32_t>(m_instantiations.size());
+      m_instantiations.push_back(copy);
+    }
+  }
+
+  build();
+}
+
+void TemplateIndex::build()
+{
+  details::sort_edges(m_explicit);
+  details::sort_edges(m_partial);
+  details::sort_edges(m_explicit_instantiations);
+
+  std::vector<SymbolEdge> instantiations;
+  instantiations.reserve(m_instantiations.size());
+
+  for (const TemplateInstantiation& inst : m_instantiations)
+    instantiations.push_back(SymbolEdge{ inst.primary, inst.specialization });
+
+  details::sort_edges(instantiations);
+
+  m_explicit_specializations = SymbolAdjacency(m_explicit);
+  m_partial_specializations = SymbolAdjacency(m_partial);
+  m_explicit_instantiations_by_template = SymbolAdjacency(m_explicit_instantiations);
+  m_instantiations_by_template = SymbolAdjacency(instantiations);
+}
+
+} // namespace libclang
@@ -0,0 +1,124 @@
+// Copyright (C) 2023 Vincent Chambrin
+// This file is part of the 'libclang-utils' project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include "libclang-utils/thread-pool.h"
+
+#include <algorithm>
+
+namespace libclang
+{
+
+/**
+ * \brief starts the worker threads
+ * \param nb_threads  number of threads, or 0 to use the number of hardware threads
+ */
+ThreadPool::ThreadPool(unsigned nb_threads)
+{
+  if (nb_threads == 0)
+    nb_threads = std::max(1u, std::thread::hardware_concurrency());
+
+  for (unsigned i(0); i < nb_threads; ++i)
+    m_queues.push_back(std::unique_ptr<Queue>(new Queue));
+
+  for (unsigned i(0); i < nb_threads; ++i)
+    m_threads.emplace_back(&ThreadPool::work, this, size_t(i));
+}
+
+/**
+ * \brief waits for the pending tasks and stops the worker threads
+ */
+ThreadPool::~ThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lock{ m_mutex };
+    m_stop = true;
+  }
+
+  m_cv.notify_all();
+
+  for (std::thread& t : m_threads)
+    t.join();
+}
+
+/**
+ * \brief adds a task to the pool
+ */
+void ThreadPool::submit(Task task)
+{
+  Queue& queue = *m_queues[m_next_queue++ % m_queues.size()];
+
+  // counted before being queued so that m_pending never underflows
+  {
+    std::lock_guard<std::mutex> lock{ m_mutex };
+    ++m_pending;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock{ queue.mutex };
+    queue.tasks.push_back(std::move(task));
+  }
+
+  m_cv.notify_one();
+}
+
+/**
+ * \brief runs one pending task
+ * \param self  index of the queue of the calling worker, or size() for other threads
+ * \return whether a task was run
+ *
+ * A worker takes tasks from the back of its own queue and steals from the
+ * front of the others.
+ */
+bool ThreadPool::runPendingTask(size_t self)
+{
+  Task task;
+
+  if (self < m_queues.size())
+  {
+    Queue& queue = *m_queues[self];
+    std::lock_guard<std::mutex> lock{ queue.mutex };
+
+    if (!queue.tasks.empty())
+    {
+      task = std::move(queue.tasks.back());
+      queue.tasks.pop_back();
+    }
+  }
+
+  for (size_t i(1); !task && i <= m_queues.size(); ++i)
+  {
+    Queue& victim = *m_queues[(self + i) % m_queues.size()];
+    std::lock_guard<std::mutex> lock{ victim.mutex };
+
+    if (!victim.tasks.empty())
+    {
+      task = std::move(victim.tasks.front());
+      victim.tasks.pop_front();
+    }
+  }
+
+  if (!task)
+    return false;
+
+  --m_pending;
+  task();
+  return true;
+}
+
+void ThreadPool::work(size_t self)
+{
+  for (;;)
+  {
+    if (runPendingTask(self))
+      continue;
+
+    std::unique_lock<std::mutex> lock{ m_mutex };
+    m_cv.wait(lock, [this]() { return m_stop || m_pending > 0; });
+
+    if (m_stop && m_pending == 0)
+      return;
+  }
+}
+
+} // namespace libclang
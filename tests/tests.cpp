@@ -6,8 +6,40 @@
 #include "catch.hpp"
 
 #include "libclang-utils/libclang.h"
+#include "libclang-utils/annotatetokens.h"
+#include "libclang-utils/ast-snapshot.h"
+#include "libclang-utils/call-graph.h"
+#include "libclang-utils/clang-cursor.h"
+#include "libclang-utils/clang-diagnostic.h"
+#include "libclang-utils/clang-file.h"
 #include "libclang-utils/clang-index.h"
+#include "libclang-utils/clang-string.h"
+#include "libclang-utils/clang-token.h"
 #include "libclang-utils/clang-translation-unit.h"
+#include "libclang-utils/class-hierarchy.h"
+#include "libclang-utils/constant-table.h"
+#include "libclang-utils/cursor-key.h"
+#include "libclang-utils/cursor-set.h"
+#include "libclang-utils/declaration-table.h"
+#include "libclang-utils/doc-comment-cache.h"
+#include "libclang-utils/eval-result.h"
+#include "libclang-utils/extent-index.h"
+#include "libclang-utils/file-table.h"
+#include "libclang-utils/hash.h"
+#include "libclang-utils/line-index.h"
+#include "libclang-utils/merkle-hash.h"
+#include "libclang-utils/node-table.h"
+#include "libclang-utils/printing-policy.h"
+#include "libclang-utils/qualified-name-cache.h"
+#include "libclang-utils/skipped-ranges.h"
+#include "libclang-utils/snapshot-diff.h"
+#include "libclang-utils/snapshot-file.h"
+#include "libclang-utils/snapshot-query.h"
+#include "libclang-utils/snapshot-store.h"
+#include "libclang-utils/symbol-key.h"
+#include "libclang-utils/template-index.h"
+#include "libclang-utils/thread-pool.h"
+#include "libclang-utils/visit-descendants.h"
 
 #include <iostream>
 #include <fstream>
@@ -68,3 +100,1326 @@ TEST_CASE("The parser is able to parse a simple function body", "[libclang]")
 
   libclang::TranslationUnit tu = index.parseTranslationUnit("test.cpp", {});
 }
+
+TEST_CASE("Diagnostics are collected and deduplicated", "[libclang]")
+{
+  if (skipTest())
+    return;
+
+  write_file("test.cpp",
+    "int foo() { return bar; }");
+
+  libclang::LibClang libclang;
+  libclang::Index index = libclang.createIndex();
+
+  libclang::TranslationUnit tu = index.parseTranslationUnit("test.cpp", {});
+  libclang::DiagnosticList diagnostics = libclang::getDiagnostics(tu);
+
+  REQUIRE(diagnostics.size() == 1);
+  REQUIRE(diagnostics.at(0).severity == CXDiagnostic_Error);
+  REQUIRE(diagnostics.at(0).line == 1);
+  REQUIRE(diagnostics.fileName(diagnostics.at(0)) == libclang::StringView("test.cpp"));
+
+  libclang::DiagnosticList merged;
+  merged.merge(diagnostics);
+  merged.merge(diagnostics);
+  REQUIRE(merged.size() == 1);
+  REQUIRE(merged.at(0).occurrences == 2);
+
+  std::vector<std::string> errors;
+  libclang::DiagnosticList loaded = libclang::loadDiagnostics(libclang, { "missing-1.dia", "missing-2.dia" }, &errors);
+  REQUIRE(loaded.empty());
+  REQUIRE(errors.size() == 2);
+}
+
+TEST_CASE("Skipped preprocessor ranges can be queried", "[libclang]")
+{
+  if (skipTest())
+    return;
+
+  write_file("test.cpp",
+    "#if 0\n"
+    "int foo();\n"
+    "#endif\n"
+    "int bar();\n");
+
+  libclang::LibClang libclang;
+  libclang::Index index = libclang.createIndex();
+
+  libclang::TranslationUnit tu = index.parseTranslationUnit("test.cpp", {}, CXTranslationUnit_DetailedPreprocessingRecord);
+  libclang::File file = tu.getFile("test.cpp");
+
+  libclang::SkippedRanges ranges = tu.skippedRanges(file);
+  REQUIRE(ranges.size() == 1);
+  REQUIRE(ranges.fileId(file) == 0);
+  REQUIRE(ranges.contains(0, 10));
+  REQUIRE_FALSE(ranges.contains(0, 30));
+
+  libclang::SkippedRanges all = tu.allSkippedRanges();
+  REQUIRE(all.size() == 1);
+}
+
+TEST_CASE("The file table assigns dense ids to the files of a translation unit", "[libclang]")
+{
+  if (skipTest())
+    return;
+
+  write_file("test.h",
+    "int foo();");
+
+  write_file("test.cpp",
+    "#include \"test.h\"\n"
+    "int bar() { return foo(); }");
+
+  libclang::LibClang libclang;
+  libclang::Index index = libclang.createIndex();
+
+  libclang::TranslationUnit tu = index.parseTranslationUnit("test.cpp", {});
+  libclang::FileTable files{ tu };
+
+  REQUIRE(files.size() == 2);
+  REQUIRE(files.depth(0) == 0);
+  REQUIRE(files.depth(1) == 1);
+  REQUIRE(files.find(tu.getFile("test.cpp")) == 0);
+  REQUIRE(files.find(tu.getFile("test.h")) == 1);
+  REQUIRE(files.name(0) == libclang::StringView("test.cpp"));
+  REQUIRE(files.fileSize(1) == 11);
+  REQUIRE(files.find(nullptr) == libclang::FileTable::NoFile);
+}
+
+TEST_CASE("The line index converts offsets to lines and columns", "[lineindex]")
+{
+  std::string text = "int a;\nint b;\r\nint c;\r\r\n";
+
+  for (int i(0); i < 20; ++i)
+    text += "/* a line that is long enough to span several SIMD blocks */\n";
+
+  libclang::LineIndex index{ text.data(), text.size() };
+
+  std::vector<unsigned> expected;
+  libclang::details::scan_line_starts_scalar(text.data(), text.size(), expected);
+
+  REQUIRE(index.lineCount() == expected.size());
+  REQUIRE(index.lineCount() == 25);
+  REQUIRE(index.lineStart(2) == 7);
+  REQUIRE(index.lineStart(3) == 15);
+  REQUIRE(index.lineStart(4) == 22);
+  REQUIRE(index.lineStart(5) == 24);
+
+  for (unsigned line(1); line <= index.lineCount(); ++line)
+  {
+    REQUIRE(index.lineStart(line) == expected.at(line - 1));
+    REQUIRE(index.lineColumn(index.lineStart(line)).line == line);
+  }
+
+  // "\n\r" is a single line break, "\n\r\n" is two
+  std::string mixed = "a\n\rb\n\r\nc";
+  libclang::LineIndex mixed_index{ mixed.data(), mixed.size() };
+  REQUIRE(mixed_index.lineCount() == 4);
+  REQUIRE(mixed_index.lineStart(2) == 3);
+  REQUIRE(mixed_index.lineStart(3) == 6);
+  REQUIRE(mixed_index.lineStart(4) == 7);
+
+  // pairs of a long run of blank lines straddle the SIMD blocks
+  std::string blank = "x";
+  for (int i(0); i < 100; ++i)
+    blank += "\r\n";
+  libclang::LineIndex blank_index{ blank.data(), blank.size() };
+  REQUIRE(blank_index.lineCount() == 101);
+  REQUIRE(blank_index.lineStart(101) == blank.size());
+
+  libclang::LineColumn pos = index.lineColumn(10);
+  REQUIRE(pos.line == 2);
+  REQUIRE(pos.column == 4);
+  REQUIRE(index.offset(pos) == 10);
+}
+
+TEST_CASE("Source text can be retrieved without copies", "[libclang]")
+{
+  if (skipTest())
+    return;
+
+  write_file("test.cpp",
+    "int foo(int a) { return a + 1; }");
+
+  libclang::LibClang libclang;
+  libclang::Index index = libclang.createIndex();
+  libclang::TranslationUnit tu = index.parseTranslationUnit("test.cpp", {});
+
+  libclang::Cursor foo = tu.getCursor().childAt(0);
+  libclang::SourceRange extent = foo.getExtent();
+  REQUIRE(extent.text(tu) == "int foo(int a) { return a + 1; }");
+
+  libclang::TokenSet tokens = tu.tokenize(extent);
+  std::vector<libclang::StringView> texts = tokens.texts();
+  REQUIRE(texts.size() == tokens.size());
+
+  for (size_t i(0); i < tokens.size(); ++i)
+  {
+    REQUIRE(texts.at(i) == tokens.at(i).getSpelling());
+    REQUIRE(tokens.at(i).text() == texts.at(i));
+  }
+
+  std::vector<libclang::SourceRange> ranges{ extent, foo.getArgument(0).getExtent() };
+  std::vector<libclang::StringView> range_texts = libclang::getTexts(tu, ranges);
+  REQUIRE(range_texts.at(1) == "int a");
+
+  REQUIRE(libclang::nullRange(libclang).text(tu).empty());
+}
+
+TEST_CASE("The AST snapshot matches the cursor tree", "[libclang]")
+{
+  if (skipTest())
+    return;
+
+  write_file("test.cpp",
+    "struct A { int x; int y; };\n"
+    "int foo(A a, int b) { if (b > 0) { return a.x; } return a.y + b; }\n"
+    "namespace ns { void bar(); }");
+
+  libclang::LibClang libclang;
+  libclang::Index index = libclang.createIndex();
+  libclang::TranslationUnit tu = index.parseTranslationUnit("test.cpp", {});
+
+  libclang::AstSnapshot snapshot{ tu };
+  REQUIRE(snapshot.size() > 10);
+  REQUIRE(snapshot.kind(snapshot.root()) == tu.getCursor().kind());
+  REQUIRE(snapshot.subtreeEnd(snapshot.root()) == snapshot.size());
+
+  for (libclang::AstSnapshot::NodeId n(0); n < snapshot.size(); ++n)
+  {
+    libclang::Cursor c = snapshot.cursor(n);
+    REQUIRE(c.kind() == snapshot.kind(n));
+    REQUIRE(c.childCount() == snapshot.childCount(n));
+
+    libclang::AstSnapshot::NodeId child = snapshot.firstChild(n);
+
+    for (size_t i(0); i < snapshot.childCount(n); ++i)
+    {
+      REQUIRE(child == snapshot.childAt(n, i));
+      REQUIRE(snapshot.parent(child) == n);
+      REQUIRE(snapshot.indexOfChild(n, child) == static_cast<int>(i));
+      REQUIRE(snapshot.cursor(child).kind() == c.childAt(i).kind());
+      REQUIRE(snapshot.cursor(child).getExtent() == c.childAt(i).getExtent());
+      REQUIRE(snapshot.subtreeEnd(child) <= snapshot.subtreeEnd(n));
+      child = snapshot.nextSibling(child);
+    }
+
+    REQUIRE(child == libclang::AstSnapshot::NoNode);
+  }
+
+  libclang::AstSnapshot::NodeId foo = snapshot.childAt(snapshot.root(), 1);
+  REQUIRE(snapshot.kind(foo) == CXCursor_FunctionDecl);
+  REQUIRE(snapshot.file(foo) == 0);
+  REQUIRE(snapshot.beginOffset(foo) == 28);
+}
+
+TEST_CASE("AST snapshots can be saved and mapped from a file", "[libclang]")
+{
+  if (skipTest())
+    return;
+
+  write_file("test.cpp",
+    "struct A { int x; };\n"
+    "int foo(A a) { return a.x; }");
+
+  libclang::LibClang libclang;
+  libclang::Index index = libclang.createIndex();
+  libclang::TranslationUnit tu = index.parseTranslationUnit("test.cpp", {});
+
+  libclang::AstSnapshot snapshot{ tu };
+  libclang::saveSnapshot(snapshot, "test.snapshot");
+
+  libclang::SnapshotFile file{ "test.snapshot" };
+  REQUIRE(file.size() == snapshot.size());
+  REQUIRE(file.fileCount() == snapshot.file_table.size());
+  REQUIRE(file.fileName(0) == "test.cpp");
+
+  for (libclang::SnapshotFile::NodeId n(0); n < file.size(); ++n)
+  {
+    REQUIRE(file.kind(n) == snapshot.kind(n));
+    REQUIRE(file.parent(n) == snapshot.parent(n));
+    REQUIRE(file.childCount(n) == snapshot.childCount(n));
+    REQUIRE(file.beginOffset(n) == snapshot.beginOffset(n));
+    REQUIRE(file.endOffset(n) == snapshot.endOffset(n));
+    REQUIRE(file.spelling(n) == snapshot.cursor(n).getSpelling());
+  }
+
+  libclang::SnapshotFile::NodeId foo = file.childAt(file.root(), 1);
+  REQUIRE(file.spelling(foo) == "foo");
+  REQUIRE(file.usr(foo) == "c:@F@foo#$@S@A#");
+
+  libclang::SnapshotFile moved = std::move(file);
+  REQUIRE(!file.isOpen());
+  REQUIRE(moved.spelling(foo) == "foo");
+
+  write_file("test.snapshot", "not a snapshot");
+  REQUIRE_THROWS_AS(libclang::SnapshotFile("test.snapshot"), std::runtime_error);
+}
+
+TEST_CASE("The extent index finds the innermost cursor at an offset", "[libclang]")
+{
+  if (skipTest())
+    return;
+
+  write_file("test.cpp",
+    "struct A { int x; };\n"
+    "int foo(A a, int b) { return a.x + b; }");
+
+  libclang::LibClang libclang;
+  libclang::Index index = libclang.createIndex();
+  libclang::TranslationUnit tu = index.parseTranslationUnit("test.cpp", {});
+
+  libclang::AstSnapshot snapshot{ tu };
+  libclang::ExtentIndex extents{ snapshot };
+  libclang::File file = tu.getFile("test.cpp");
+
+  std::vector<unsigned> offsets;
+  for (unsigned off(0); off < 60; off += 3)
+    offsets.push_back(off);
+
+  std::vector<libclang::AstSnapshot::NodeId> nodes = extents.innermost(0, offsets);
+  libclang::NodeLists chains = extents.enclosing(0, offsets);
+  REQUIRE(chains.size() == offsets.size());
+
+  for (size_t i(0); i < offsets.size(); ++i)
+  {
+    REQUIRE(nodes.at(i) == extents.innermost(0, offsets.at(i)));
+    REQUIRE(chains.count(i) == extents.enclosing(0, offsets.at(i)).size());
+
+    if (nodes.at(i) == libclang::AstSnapshot::NoNode)
+      continue;
+
+    REQUIRE(chains.at(i, chains.count(i) - 1) == nodes.at(i));
+
+    libclang::SpellingLocation loc = libclang::SourceLocation(libclang, libclang.clang_getLocationForOffset(tu, file, offsets.at(i))).getSpellingLocation();
+    libclang::Cursor expected = tu.getCursor(tu.getLocation(file, loc.line, loc.col));
+    REQUIRE(snapshot.kind(nodes.at(i)) == expected.kind());
+  }
+
+  // offset of "x" in "a.x"
+  libclang::AstSnapshot::NodeId member = extents.innermost(0, 52);
+  REQUIRE(snapshot.kind(member) == CXCursor_MemberRefExpr);
+
+  std::vector<unsigned> unsorted{ 52, 0, 30 };
+  REQUIRE(extents.innermost(0, unsorted).at(0) == member);
+}
+
+TEST_CASE("The thread pool runs all the tasks of a parallel loop", "[threadpool]")
+{
+  libclang::ThreadPool pool{ 4 };
+  REQUIRE(pool.size() == 4);
+
+  std::vector<int> values(1000, 0);
+  pool.parallelFor(values.size(), [&values](size_t i) {
+    values[i] = static_cast<int>(i) * 2;
+    });
+
+  for (size_t i(0); i < values.size(); ++i)
+    REQUIRE(values[i] == static_cast<int>(i) * 2);
+
+  REQUIRE_THROWS_AS(pool.parallelFor(10, [](size_t i) {
+    if (i == 5)
+      throw std::runtime_error("error");
+    }), std::runtime_error);
+}
+
+TEST_CASE("Queries run in parallel over an AST snapshot", "[libclang]")
+{
+  if (skipTest())
+    return;
+
+  write_file("test.cpp",
+    "int a() { return 1; }\n"
+    "int b() { return a() + 2; }\n"
+    "struct S { int f() { return b(); } };\n"
+    "int c(S s) { return s.f() + a(); }");
+
+  libclang::LibClang libclang;
+  libclang::Index index = libclang.createIndex();
+  libclang::TranslationUnit tu = index.parseTranslationUnit("test.cpp", {});
+
+  libclang::AstSnapshot snapshot{ tu };
+  libclang::ThreadPool pool{ 3 };
+  libclang::SnapshotQuery query{ pool, snapshot };
+
+  auto is_call = [](const libclang::AstSnapshot& s, libclang::AstSnapshot::NodeId n) {
+    return s.kind(n) == CXCursor_CallExpr;
+  };
+
+  std::vector<libclang::AstSnapshot::NodeId> calls = query.findAll(is_call);
+
+  std::vector<libclang::AstSnapshot::NodeId> expected;
+  for (libclang::AstSnapshot::NodeId n(0); n < snapshot.size(); ++n)
+  {
+    if (is_call(snapshot, n))
+      expected.push_back(n);
+  }
+
+  REQUIRE(calls == expected);
+  REQUIRE(calls.size() == 4);
+  REQUIRE(query.count(is_call) == 4);
+}
+
+TEST_CASE("Cursor keys compare like clang_equalCursors", "[libclang]")
+{
+  if (skipTest())
+    return;
+
+  write_file("test.cpp",
+    "void f();\n"
+    "struct A { int x; friend void f(); };");
+
+  libclang::LibClang libclang;
+  libclang::Index index = libclang.createIndex();
+  libclang::TranslationUnit tu = index.parseTranslationUnit("test.cpp", {});
+
+  libclang::Cursor friend_decl = tu.getCursor().childAt(1).childAt(1);
+  REQUIRE(friend_decl.kind() == CXCursor_FriendDecl);
+
+  for (CXCursor c : { CXCursor(tu.getCursor().childAt(1).childAt(0)), CXCursor(friend_decl) })
+  {
+    // data[1] is the "first in declaration group" pointer of declarations
+    CXCursor other = c;
+    other.data[1] = &other;
+
+    REQUIRE(libclang.clang_equalCursors(c, other));
+    REQUIRE(libclang::CursorKey(c) == libclang::CursorKey(other));
+  }
+}
+
+TEST_CASE("The node table maps cursors to compact handles", "[libclang]")
+{
+  if (skipTest())
+    return;
+
+  write_file("test.cpp",
+    "struct A { int x; };\n"
+    "int foo(A a) { return a.x; }");
+
+  libclang::LibClang libclang;
+  libclang::Index index = libclang.createIndex();
+  libclang::TranslationUnit tu = index.parseTranslationUnit("test.cpp", {});
+
+  libclang::AstSnapshot snapshot{ tu };
+  libclang::NodeTable nodes{ snapshot };
+  REQUIRE(nodes.size() == snapshot.size());
+  REQUIRE(sizeof(libclang::NodeTable::NodeId) == 4);
+
+  libclang::Cursor foo = tu.getCursor().childAt(1);
+  libclang::NodeTable::NodeId foo_id = nodes.find(foo);
+  REQUIRE(foo_id == snapshot.childAt(snapshot.root(), 1));
+  REQUIRE(nodes.cursor(foo_id) == foo);
+  REQUIRE(nodes.insert(foo) == foo_id);
+  REQUIRE(nodes.size() == snapshot.size());
+
+  std::vector<libclang::NodeTable::NodeId> children = nodes.children(foo_id);
+  REQUIRE(children.size() == foo.childCount());
+
+  for (size_t i(0); i < children.size(); ++i)
+    REQUIRE(nodes.cursor(children.at(i)) == foo.childAt(i));
+
+  libclang::TokenSet tokens = tu.tokenize(foo.getExtent());
+  std::vector<libclang::NodeTable::NodeId> annotations = nodes.annotateTokens(tu, tokens);
+  std::vector<libclang::Cursor> cursors = libclang::annotateTokens(tu, tokens);
+  REQUIRE(annotations.size() == cursors.size());
+
+  for (size_t i(0); i < cursors.size(); ++i)
+    REQUIRE(nodes.cursor(annotations.at(i)) == cursors.at(i));
+}
+
+TEST_CASE("hash64 implements XXH64", "[hash]")
+{
+  REQUIRE(libclang::hash64("") == 0xEF46DB3751D8E999ull);
+  REQUIRE(libclang::hash64("a") == 0xD24EC4F1A98C6E5Bull);
+  REQUIRE(libclang::hash64("abc") == 0x44BC2CF5AD770999ull);
+  REQUIRE(libclang::hash64("Nobody inspects the spammish repetition") == 0xFBCEA83C8A378BF1ull);
+}
+
+TEST_CASE("Declaration changes are detected between two parses", "[libclang]")
+{
+  if (skipTest())
+    return;
+
+  write_file("test.cpp",
+    "int a() { return 1; }\n"
+    "int b() { return 2; }\n"
+    "struct S { int x; };\n"
+    "int c() { return 3; }\n"
+    "int e(int x) { return x + 1; }");
+
+  libclang::LibClang libclang;
+  libclang::Index index = libclang.createIndex();
+  libclang::TranslationUnit tu = index.parseTranslationUnit("test.cpp", {});
+
+  libclang::DeclarationDigest before{ libclang::AstSnapshot(tu), 0 };
+  REQUIRE(before.size() == 6);
+
+  write_file("test.cpp",
+    "// a comment that moves everything\n"
+    "int a() { return 1; }\n"
+    "int b() { return 42; }\n"
+    "struct S { int x; int y; };\n"
+    "int d() { return 3; }\n"
+    "int e(int x) { return x - 1; }");
+
+  REQUIRE(tu.reparseTranslationUnit() == CXError_Success);
+
+  libclang::DeclarationDigest after{ libclang::AstSnapshot(tu), 0 };
+
+  std::vector<libclang::DeclarationChange> changes = libclang::diff(before, after);
+  std::vector<std::string> summary;
+
+  for (const libclang::DeclarationChange& c : changes)
+  {
+    switch (c.kind)
+    {
+    case libclang::DeclarationChange::Added:
+      summary.push_back("+" + after.usr(c.after).toStdString());
+      break;
+    case libclang::DeclarationChange::Removed:
+      summary.push_back("-" + before.usr(c.before).toStdString());
+      break;
+    case libclang::DeclarationChange::Changed:
+      summary.push_back("~" + after.usr(c.after).toStdString());
+      break;
+    case libclang::DeclarationChange::Moved:
+      summary.push_back(">" + after.usr(c.after).toStdString());
+      break;
+    }
+  }
+
+  std::vector<std::string> expected{ "-c:@F@c#", ">c:@F@a#", "~c:@F@b#", "~c:@S@S", ">c:@S@S@FI@x", "+c:@S@S@FI@y", "+c:@F@d#", "~c:@F@e#I#" };
+  REQUIRE(summary == expected);
+}
+
+TEST_CASE("The snapshot store shares header fragments between translation units", "[libclang]")
+{
+  if (skipTest())
+    return;
+
+  write_file("common.h",
+    "#pragma once\n"
+    "struct Point { int x; int y; };\n"
+    "inline int dot(Point a, Point b) { return a.x * b.x + a.y * b.y; }");
+
+  write_file("a.cpp",
+    "#include \"common.h\"\n"
+    "int a() { return dot(Point{1, 2}, Point{3, 4}); }");
+
+  write_file("b.cpp",
+    "#include \"common.h\"\n"
+    "int b(Point p) { return dot(p, p); }");
+
+  libclang::LibClang libclang;
+  libclang::Index index = libclang.createIndex();
+  libclang::TranslationUnit tu_a = index.parseTranslationUnit("a.cpp", {});
+  libclang::TranslationUnit tu_b = index.parseTranslationUnit("b.cpp", {});
+
+  libclang::SnapshotStore store;
+  libclang::SnapshotStore::UnitId a = store.add(libclang::AstSnapshot(tu_a));
+  libclang::SnapshotStore::UnitId b = store.add(libclang::AstSnapshot(tu_b));
+
+  REQUIRE(store.unitCount() == 2);
+  REQUIRE(store.string(store.unit(a).name) == "a.cpp");
+  REQUIRE(store.unit(a).fragments.size() == 2);
+  REQUIRE(store.unit(b).fragments.size() == 2);
+  REQUIRE(store.fragmentCount() == 3);
+
+  const libclang::SnapshotFragment& header = store.fragment(store.unit(a).fragments.front());
+  REQUIRE(store.unit(b).fragments.front() == store.unit(a).fragments.front());
+  REQUIRE(header.references == 2);
+  REQUIRE(store.string(header.spellings.front()) == "Point");
+  REQUIRE(header.parents.front() == libclang::AstSnapshot::NoNode);
+
+  REQUIRE(store.storedNodeCount() + header.size() == store.referencedNodeCount());
+}
+
+TEST_CASE("Structural hashes identify identical subtrees", "[libclang]")
+{
+  if (skipTest())
+    return;
+
+  write_file("test.cpp",
+    "namespace a { struct S { int x; }; int f(S s) { return s.x * 2; } }\n"
+    "namespace b { struct S { int x; }; int g(S s) { return s.x * 2; } }\n"
+    "namespace c { struct S { int x; }; int h(S s) { return s.x * 3; } }\n"
+    "struct { int v; } unnamed;");
+
+  libclang::LibClang libclang;
+  libclang::Index index = libclang.createIndex();
+  libclang::TranslationUnit tu = index.parseTranslationUnit("test.cpp", {});
+
+  libclang::AstSnapshot snapshot{ tu };
+  std::vector<uint64_t> hashes = libclang::structuralHashes(snapshot);
+
+  for (libclang::AstSnapshot::NodeId n(0); n < snapshot.size(); ++n)
+    REQUIRE(libclang::structuralHash(snapshot.cursor(n)) == hashes.at(n));
+
+  auto body = [&snapshot](size_t ns) {
+    libclang::AstSnapshot::NodeId fun = snapshot.childAt(snapshot.childAt(snapshot.root(), ns), 1);
+    return snapshot.childAt(fun, snapshot.childCount(fun) - 1);
+  };
+
+  auto struct_decl = [&snapshot](size_t ns) {
+    return snapshot.childAt(snapshot.childAt(snapshot.root(), ns), 0);
+  };
+
+  REQUIRE(snapshot.kind(body(0)) == CXCursor_CompoundStmt);
+  REQUIRE(hashes.at(body(0)) == hashes.at(body(1)));
+  REQUIRE(hashes.at(body(0)) != hashes.at(body(2)));
+  // the type of a struct is spelled with its namespace, its fields are not
+  REQUIRE(hashes.at(struct_decl(0)) != hashes.at(struct_decl(2)));
+  REQUIRE(hashes.at(snapshot.firstChild(struct_decl(0))) == hashes.at(snapshot.firstChild(struct_decl(2))));
+  REQUIRE(hashes.at(snapshot.childAt(snapshot.root(), 0)) != hashes.at(snapshot.childAt(snapshot.root(), 1)));
+
+  REQUIRE(libclang::details::normalize_spelling("struct (unnamed struct at test.cpp:4:1)") == "struct (unnamed struct)");
+  REQUIRE(libclang::details::normalize_spelling("look at this") == "look at this");
+}
+
+TEST_CASE("Structural hashes distinguish operators and boolean literals", "[libclang]")
+{
+  if (skipTest())
+    return;
+
+  write_file("test.cpp",
+    "int f0(int a, int b) { return a+b; }\n"
+    "int f1(int a, int b) { return a-b; }\n"
+    "int f2(int a, int b) { return a + b; }\n"
+    "bool f3(int a, int b) { return a<1; }\n"
+    "bool f4(int a, int b) { return a>1; }\n"
+    "int f5(int a, int b) { return a+=b; }\n"
+    "int f6(int a, int b) { return a-=b; }\n"
+    "bool f7(int a, int b) { return true; }\n"
+    "bool f8(int a, int b) { return false; }\n"
+    "int f9(int a, int b) { return -a; }\n"
+    "int f10(int a, int b) { return a--; }\n");
+
+  libclang::LibClang libclang;
+  libclang::Index index = libclang.createIndex();
+  libclang::TranslationUnit tu = index.parseTranslationUnit("test.cpp", {});
+
+  libclang::AstSnapshot snapshot{ tu };
+  std::vector<uint64_t> hashes = libclang::structuralHashes(snapshot);
+
+  auto body = [&](size_t i) {
+    libclang::AstSnapshot::NodeId fun = snapshot.childAt(snapshot.root(), i);
+    return hashes.at(snapshot.childAt(fun, snapshot.childCount(fun) - 1));
+  };
+
+  REQUIRE(body(0) != body(1));
+  REQUIRE(body(0) == body(2));
+  REQUIRE(body(3) != body(4));
+  REQUIRE(body(5) != body(6));
+  REQUIRE(body(7) != body(8));
+  REQUIRE(body(9) != body(10));
+}
+
+TEST_CASE("The recursive visitor walks the tree in a single traversal", "[libclang]")
+{
+  if (skipTest())
+    return;
+
+  write_file("test.cpp",
+    "struct A { int x; int y; };\n"
+    "int foo(A a) { return a.x + a.y; }\n"
+    "int bar() { return 0; }");
+
+  libclang::LibClang libclang;
+  libclang::Index index = libclang.createIndex();
+  libclang::TranslationUnit tu = index.parseTranslationUnit("test.cpp", {});
+
+  libclang::AstSnapshot snapshot{ tu };
+  libclang::Cursor root = tu.getCursor();
+
+  std::vector<CXCursorKind> kinds;
+  bool broken = root.visitRecursively([&](const libclang::Cursor& c, const libclang::Cursor& parent) {
+    libclang::AstSnapshot::NodeId n = static_cast<libclang::AstSnapshot::NodeId>(kinds.size() + 1);
+    REQUIRE(parent.kind() == snapshot.kind(snapshot.parent(n)));
+    kinds.push_back(c.kind());
+    return libclang::VisitResult::Recurse;
+    });
+
+  REQUIRE(!broken);
+  REQUIRE(kinds.size() == snapshot.size() - 1);
+  REQUIRE(std::equal(kinds.begin(), kinds.end(), snapshot.kinds.begin() + 1));
+
+  // skipping function bodies
+  size_t count = 0;
+  root.visitRecursively([&count](const libclang::Cursor& c, const libclang::Cursor&) {
+    ++count;
+    return c.kind() == CXCursor_FunctionDecl ? libclang::VisitResult::SkipSubtree : libclang::VisitResult::Recurse;
+    });
+
+  REQUIRE(count == 5);
+
+  std::string last;
+  broken = root.visitRecursively([&last](const libclang::Cursor& c, const libclang::Cursor&) {
+    last = c.getSpelling();
+    return c.kind() == CXCursor_FunctionDecl ? libclang::VisitResult::Break : libclang::VisitResult::SkipSubtree;
+    });
+
+  REQUIRE(broken);
+  REQUIRE(last == "foo");
+}
+
+TEST_CASE("Descendants can be filtered by kind at compile time", "[libclang]")
+{
+  if (skipTest())
+    return;
+
+  write_file("test.cpp",
+    "struct A { int get() const { return 1; } void set(int) { } };\n"
+    "int foo(A a) { struct Local { void m() { } }; return a.get(); }\n"
+    "namespace ns { int bar() { return foo(A()); } }\n"
+    "int global = foo(A());");
+
+  libclang::LibClang libclang;
+  libclang::Index index = libclang.createIndex();
+  libclang::TranslationUnit tu = index.parseTranslationUnit("test.cpp", {});
+
+  static_assert(libclang::details::KindFilter<CXCursor_FunctionDecl>::mask.contains(CXCursor_FunctionDecl), "");
+  static_assert(!libclang::details::KindFilter<CXCursor_FunctionDecl>::mask.contains(CXCursor_CXXMethod), "");
+
+  std::vector<std::string> names;
+  libclang::visitDescendants<CXCursor_FunctionDecl, CXCursor_CXXMethod>(tu.getCursor(), [&names](const libclang::Cursor& c) {
+    names.push_back(c.getSpelling());
+    });
+
+  REQUIRE(names == std::vector<std::string>{ "get", "set", "foo", "m", "bar" });
+
+  names.clear();
+  libclang::VisitDescendantsOptions opts;
+  opts.skipFunctionBodies = true;
+  libclang::visitDescendants<CXCursor_FunctionDecl, CXCursor_CXXMethod>(tu.getCursor(), [&names](const libclang::Cursor& c) {
+    names.push_back(c.getSpelling());
+    }, opts);
+
+  REQUIRE(names == std::vector<std::string>{ "get", "set", "foo", "bar" });
+
+  size_t calls = 0;
+  libclang::visitDescendants<CXCursor_CallExpr>(tu.getCursor(), [&calls](const libclang::Cursor&) {
+    ++calls;
+    return libclang::VisitResult::SkipSubtree;
+    });
+
+  REQUIRE(calls == 3);
+
+  calls = 0;
+  libclang::visitDescendants<CXCursor_CallExpr>(tu.getCursor(), [&calls](const libclang::Cursor&) {
+    ++calls;
+    return libclang::VisitResult::SkipSubtree;
+    }, opts);
+
+  // only the call in the initializer of the global variable
+  REQUIRE(calls == 1);
+}
+
+TEST_CASE("Qualified names are built from cached scopes", "[libclang]")
+{
+  if (skipTest())
+    return;
+
+  write_file("test.cpp",
+    "namespace ns { namespace inner { struct Class { void method(); int field; }; } }\n"
+    "void ns::inner::Class::method() { }\n"
+    "int top();\n"
+    "extern \"C\" { int cfun(); }\n"
+    "namespace ns { extern \"C++\" { int g(); } }\n"
+    "namespace { int hidden; }");
+
+  libclang::LibClang libclang;
+  libclang::Index index = libclang.createIndex();
+  libclang::TranslationUnit tu = index.parseTranslationUnit("test.cpp", {});
+
+  libclang::QualifiedNameCache names{ libclang };
+
+  libclang::Cursor ns = tu.getCursor().childAt(0);
+  libclang::Cursor klass = ns.childAt(0).childAt(0);
+  libclang::Cursor method_decl = klass.childAt(0);
+  libclang::Cursor method_def = tu.getCursor().childAt(1);
+
+  REQUIRE(names.qualifiedName(method_decl) == "ns::inner::Class::method");
+  REQUIRE(names.size() == 4);
+
+  // the out-of-line definition has the same canonical cursor
+  REQUIRE(names.get(method_def) == names.get(method_decl));
+  REQUIRE(names.size() == 4);
+
+  REQUIRE(names.qualifiedName(klass.childAt(1)) == "ns::inner::Class::field");
+  REQUIRE(names.size() == 5);
+
+  libclang::ArrayView<libclang::QualifiedNameCache::EntryId> ancestors = names.ancestors(names.get(method_decl));
+  REQUIRE(ancestors.size() == 3);
+  REQUIRE(names.name(ancestors[0]) == "ns");
+  REQUIRE(names.name(ancestors[1]) == "inner");
+  REQUIRE(ancestors.back() == names.find(klass));
+  REQUIRE(names.cursor(ancestors.back()) == klass);
+
+  REQUIRE(names.qualifiedName(tu.getCursor().childAt(2)) == "top");
+  REQUIRE(names.ancestors(names.find(tu.getCursor().childAt(2))).empty());
+
+  // linkage specifications don't add a scope
+  libclang::Cursor cfun = tu.getCursor().childAt(3).childAt(0);
+  REQUIRE(names.qualifiedName(cfun) == "cfun");
+  REQUIRE(names.ancestors(names.find(cfun)).empty());
+  REQUIRE(names.qualifiedName(tu.getCursor().childAt(4).childAt(0).childAt(0)) == "ns::g");
+
+  REQUIRE(names.qualifiedName(tu.getCursor().childAt(5).childAt(0)) == "(anonymous namespace)::hidden");
+}
+
+TEST_CASE("Symbols are keyed by a hash of their USR", "[libclang]")
+{
+  if (skipTest())
+    return;
+
+  write_file("test.cpp",
+    "namespace ns { int foo(int); int foo(double); }\n"
+    "int ns::foo(int n) { return n; }");
+
+  libclang::LibClang libclang;
+  libclang::Index index = libclang.createIndex();
+  libclang::TranslationUnit tu = index.parseTranslationUnit("test.cpp", {});
+
+  libclang::Cursor ns = tu.getCursor().childAt(0);
+  libclang::Cursor foo_int = ns.childAt(0);
+  libclang::Cursor foo_double = ns.childAt(1);
+  libclang::Cursor foo_def = tu.getCursor().childAt(1);
+
+  libclang::ClangString usr{ libclang, libclang.clang_getCursorUSR(foo_int) };
+  REQUIRE(usr.view() == foo_int.getUSR());
+
+  REQUIRE(libclang::symbolKey(foo_int) == libclang::symbolKey(usr.view()));
+  REQUIRE(libclang::symbolKey(foo_int) == libclang::symbolKey(foo_def));
+  REQUIRE(libclang::symbolKey(foo_int) != libclang::symbolKey(foo_double));
+  REQUIRE(libclang::symbolKey(libclang::StringView()).isNull());
+
+  libclang::SymbolKeyTable keys;
+  libclang::SymbolKey k = keys.insert(foo_int);
+  REQUIRE(keys.insert(foo_def) == k);
+  REQUIRE(keys.insert(foo_double) != k);
+  REQUIRE(keys.size() == 2);
+  REQUIRE(keys.usr(k) == foo_int.getUSR());
+  REQUIRE(keys.find(foo_double.getUSR()) == libclang::symbolKey(foo_double));
+  REQUIRE(keys.find("c:@F@unknown#").isNull());
+  REQUIRE(keys.collisions() == 0);
+}
+
+TEST_CASE("Cursor sets detect already visited cursors", "[libclang]")
+{
+  if (skipTest())
+    return;
+
+  write_file("test.cpp",
+    "struct A { int x; };\n"
+    "int foo(A a) { return a.x; }");
+
+  libclang::LibClang libclang;
+  libclang::Index index = libclang.createIndex();
+  libclang::TranslationUnit tu = index.parseTranslationUnit("test.cpp", {});
+
+  std::vector<CXCursor> cursors;
+  tu.getCursor().visitRecursively([&cursors](const libclang::Cursor& c, const libclang::Cursor&) {
+    cursors.push_back(c);
+    return libclang::VisitResult::Recurse;
+    });
+
+  libclang::CursorSet native{ libclang };
+  libclang::FlatCursorSet flat;
+
+  for (const CXCursor& c : cursors)
+  {
+    REQUIRE(native.insert(c) == flat.insert(c));
+    REQUIRE(native.contains(c));
+    REQUIRE(flat.contains(c));
+  }
+
+  REQUIRE(flat.size() == cursors.size());
+
+  for (const CXCursor& c : cursors)
+  {
+    REQUIRE(!native.insert(c));
+    REQUIRE(!flat.insert(c));
+  }
+
+  // the definition of foo is a different cursor than its canonical declaration
+  libclang::Cursor foo = tu.getCursor().childAt(1);
+  REQUIRE(flat.contains(libclang.clang_getCanonicalCursor(foo)));
+  REQUIRE(!flat.contains(tu.getCursor()));
+
+  flat.clear();
+  REQUIRE(flat.empty());
+  REQUIRE(!flat.contains(cursors.front()));
+}
+
+TEST_CASE("Declaration tables only fill the requested columns", "[libclang]")
+{
+  if (skipTest())
+    return;
+
+  write_file("common.h",
+    "#pragma once\n"
+    "class Shape { public: virtual double area() const; private: int id; };");
+
+  write_file("a.cpp",
+    "#include \"common.h\"\n"
+    "double Shape::area() const { int local = 0; return local; }");
+
+  write_file("b.cpp",
+    "#include \"common.h\"\n"
+    "int count(const Shape& s);");
+
+  libclang::LibClang libclang;
+  libclang::Index index = libclang.createIndex();
+  libclang::TranslationUnit tu_a = index.parseTranslationUnit("a.cpp", {});
+  libclang::TranslationUnit tu_b = index.parseTranslationUnit("b.cpp", {});
+
+  using Table = libclang::DeclarationTable;
+
+  Table names{ tu_a, Table::Name | Table::Kind };
+  REQUIRE(names.unitCount() == 1);
+  REQUIRE(names.kinds.size() == names.size());
+  REQUIRE(names.accesses.empty());
+  REQUIRE(names.types.empty());
+
+  // class, method, field, out-of-line method; access specifiers are skipped
+  // and 'local' is in a function body
+  REQUIRE(names.size() == 4);
+  REQUIRE(names.name(0) == "Shape");
+  REQUIRE(names.kinds.at(0) == CXCursor_ClassDecl);
+  REQUIRE(names.name(2) == "id");
+  REQUIRE(names.name(3) == "area");
+
+  Table main_only{ tu_a, Table::Name, Table::MainFileOnly };
+  REQUIRE(main_only.size() == 1);
+  REQUIRE(main_only.name(0) == "area");
+
+  libclang::ThreadPool pool{ 2 };
+  const unsigned fields = Table::AllFields;
+  Table all = libclang::extractDeclarations(pool, { &tu_a, &tu_b }, fields);
+
+  REQUIRE(all.unitCount() == 2);
+  REQUIRE(all.unit_offsets.at(1) == 4);
+  REQUIRE(all.size() == 4 + 5);
+
+  REQUIRE(all.accesses.at(2) == CX_CXXPrivate);
+  REQUIRE(all.type(1) == "double () const");
+  REQUIRE(all.file(0) == "./common.h");
+  REQUIRE(all.file(3) == "a.cpp");
+  REQUIRE(all.lines.at(3) == 2);
+  REQUIRE(!all.isDefinition(1));
+  REQUIRE(all.isDefinition(3));
+  REQUIRE(all.symbols.at(1) == all.symbols.at(3));
+
+  // 'count' and its parameter 's'
+  REQUIRE(all.name(7) == "count");
+  REQUIRE(all.name(8) == "s");
+  REQUIRE(all.type(8) == "const Shape &");
+  REQUIRE(all.symbols.at(0) == all.symbols.at(4));
+
+  Table other{ Table::Name };
+  REQUIRE_THROWS(other.append(all));
+}
+
+TEST_CASE("The class hierarchy is indexed by symbol keys", "[libclang]")
+{
+  if (skipTest())
+    return;
+
+  write_file("shapes.h",
+    "#pragma once\n"
+    "struct Shape { virtual double area() const = 0; virtual ~Shape(); virtual operator bool() const; };\n"
+    "struct Circle : Shape { double area() const override; ~Circle() override; operator bool() const override; };\n"
+    "struct Square : virtual Shape { double area() const override; };");
+
+  write_file("a.cpp",
+    "#include \"shapes.h\"\n"
+    "struct Unit : Circle { double area() const override { return 3.14; } };");
+
+  write_file("b.cpp",
+    "#include \"shapes.h\"\n"
+    "struct Tile : Square, Circle { double area() const override { return 1; } };");
+
+  libclang::LibClang libclang;
+  libclang::Index index = libclang.createIndex();
+  libclang::TranslationUnit tu_a = index.parseTranslationUnit("a.cpp", {});
+  libclang::TranslationUnit tu_b = index.parseTranslationUnit("b.cpp", {});
+
+  libclang::Cursor shape = tu_b.getCursor().childAt(0);
+  libclang::Cursor circle = tu_b.getCursor().childAt(1);
+  libclang::Cursor square = tu_b.getCursor().childAt(2);
+  libclang::Cursor tile = tu_b.getCursor().childAt(3);
+  libclang::Cursor unit = tu_a.getCursor().childAt(3);
+
+  REQUIRE(!circle.childAt(0).isVirtualBase());
+  REQUIRE(square.childAt(0).isVirtualBase());
+
+  libclang::Cursor tile_area = tile.childAt(2);
+  std::vector<libclang::Cursor> overridden = tile_area.getOverriddenCursors();
+  REQUIRE(overridden.size() == 2);
+  REQUIRE(overridden.front().getSemanticParent() == square);
+  REQUIRE(overridden.back().getSemanticParent() == circle);
+
+  libclang::ClassHierarchy hierarchy{ tu_a };
+  REQUIRE(hierarchy.inheritance().size() == 3);
+  REQUIRE(hierarchy.derivedClasses(libclang::symbolKey(circle)).size() == 1);
+
+  libclang::ClassHierarchy hierarchy_b{ tu_b };
+  libclang::ClassHierarchy bulk;
+  bulk.merge({ &hierarchy, &hierarchy_b });
+
+  hierarchy.merge(hierarchy_b);
+  REQUIRE(hierarchy.inheritance().size() == 5);
+  REQUIRE(bulk.inheritance() == hierarchy.inheritance());
+  REQUIRE(bulk.overrides() == hierarchy.overrides());
+
+  libclang::SymbolKey shape_key = libclang::symbolKey(shape);
+  libclang::SymbolKey circle_key = libclang::symbolKey(circle);
+  REQUIRE(hierarchy.bases(circle_key).size() == 1);
+  REQUIRE(hierarchy.bases(circle_key).front() == shape_key);
+  REQUIRE(hierarchy.bases(libclang::symbolKey(tile)).size() == 2);
+  REQUIRE(hierarchy.derivedClasses(circle_key).size() == 2);
+  REQUIRE(hierarchy.derivedClasses(shape_key).size() == 2);
+  REQUIRE(hierarchy.allDerivedClasses(shape_key).size() == 4);
+  REQUIRE(hierarchy.allDerivedClasses(libclang::symbolKey(unit)).empty());
+
+  libclang::SymbolKey shape_area = libclang::symbolKey(shape.childAt(0));
+  libclang::SymbolKey circle_area = libclang::symbolKey(circle.childAt(1));
+  REQUIRE(hierarchy.overridingMethods(shape_area).size() == 2);
+  REQUIRE(hierarchy.overriddenMethods(circle_area).size() == 1);
+  REQUIRE(hierarchy.overriddenMethods(circle_area).front() == shape_area);
+  REQUIRE(hierarchy.overridingMethods(circle_area).size() == 2);
+  REQUIRE(hierarchy.overriddenMethods(libclang::symbolKey(tile_area)).size() == 2);
+
+  // destructors and conversion functions override too
+  REQUIRE(hierarchy.overriddenMethods(libclang::symbolKey(circle.childAt(2))).size() == 1);
+  REQUIRE(hierarchy.overriddenMethods(libclang::symbolKey(circle.childAt(2))).front() == libclang::symbolKey(shape.childAt(1)));
+  REQUIRE(hierarchy.overriddenMethods(libclang::symbolKey(circle.childAt(3))).size() == 1);
+  REQUIRE(hierarchy.overriddenMethods(libclang::symbolKey(circle.childAt(3))).front() == libclang::symbolKey(shape.childAt(2)));
+}
+
+TEST_CASE("Template instantiations are counted across translation units", "[libclang]")
+{
+  if (skipTest())
+    return;
+
+  write_file("templates.h",
+    "#pragma once\n"
+    "template<class T> struct Box { T value; };\n"
+    "template<class T> struct Box<T*> { T* ptr; };\n"
+    "template<> struct Box<bool> { bool flag; };\n"
+    "template<class T> T twice(T x) { return x + x; }\n"
+    "template<int N> struct Fixed { char data[N]; };");
+
+  write_file("a.cpp",
+    "#include \"templates.h\"\n"
+    "Box<int> a; Box<bool> f; Box<char*> p; int u = twice(2); Fixed<4> fx;\n"
+    "template struct Box<long>;\n"
+    "extern template struct Box<short>;");
+
+  write_file("b.cpp",
+    "#include \"templates.h\"\n"
+    "Box<int> b; double v = twice(1.5);");
+
+  libclang::LibClang libclang;
+  libclang::Index index = libclang.createIndex();
+  libclang::TranslationUnit tu_a = index.parseTranslationUnit("a.cpp", {});
+  libclang::TranslationUnit tu_b = index.parseTranslationUnit("b.cpp", {});
+
+  libclang::Cursor box = tu_a.getCursor().childAt(0);
+  libclang::Cursor box_ptr = tu_a.getCursor().childAt(1);
+  libclang::Cursor box_bool = tu_a.getCursor().childAt(2);
+  libclang::Cursor twice = tu_a.getCursor().childAt(3);
+  libclang::Cursor fixed = tu_a.getCursor().childAt(4);
+
+  REQUIRE(box.getTemplateCursorKind() == CXCursor_StructDecl);
+  REQUIRE(box_ptr.getSpecializedCursorTemplate() == box);
+  REQUIRE(box_bool.getSpecializedCursorTemplate() == box);
+  REQUIRE(box_bool.getNumTemplateArguments() == 1);
+  REQUIRE(box_bool.getTemplateArgumentKind(0) == CXTemplateArgumentKind_Type);
+  REQUIRE(box_bool.getTemplateArgumentType(0).getSpelling() == "bool");
+
+  libclang::TemplateIndex templates{ tu_a };
+  REQUIRE(templates.unitCount() == 1);
+  REQUIRE(templates.partialSpecializations(libclang::symbolKey(box)).size() == 1);
+  REQUIRE(templates.explicitSpecializations(libclang::symbolKey(box)).size() == 1);
+  REQUIRE(templates.explicitSpecializations(libclang::symbolKey(box)).front() == libclang::symbolKey(box_bool));
+  REQUIRE(templates.explicitInstantiations(libclang::symbolKey(box)).size() == 2);
+
+  // Box<bool> is an explicit specialization, Box<char*> instantiates the partial specialization,
+  // Box<long> is explicitly instantiated and Box<short> is instantiated in another unit
+  REQUIRE(templates.instantiations().size() == 5);
+  REQUIRE(templates.instantiationsOf(libclang::symbolKey(box)).size() == 2);
+  REQUIRE(templates.instantiationsOf(libclang::symbolKey(box_ptr)).size() == 1);
+  REQUIRE(templates.instantiationsOf(libclang::symbolKey(twice)).size() == 1);
+
+  libclang::SymbolKey fixed_4 = templates.instantiationsOf(libclang::symbolKey(fixed)).front();
+  const libclang::TemplateInstantiation* inst = templates.findInstantiation(fixed_4);
+  REQUIRE(inst != nullptr);
+  REQUIRE(templates.arguments(*inst).size() == 1);
+  REQUIRE(templates.arguments(*inst).front().kind == CXTemplateArgumentKind_Integral);
+  REQUIRE(templates.arguments(*inst).front().value == 4);
+
+  libclang::TemplateIndex templates_b{ tu_b };
+  templates.merge({ &templates_b });
+  REQUIRE(templates.unitCount() == 2);
+  REQUIRE(templates.instantiations().size() == 6);
+  REQUIRE(templates.instantiationsOf(libclang::symbolKey(twice)).size() == 2);
+
+  std::vector<const libclang::TemplateInstantiation*> duplicated = templates.duplicatedInstantiations();
+  REQUIRE(duplicated.size() == 1);
+  REQUIRE(duplicated.front()->primary == libclang::symbolKey(box));
+  REQUIRE(duplicated.front()->unit_count == 2);
+  REQUIRE(templates.string(templates.arguments(*duplicated.front()).front().type) == "int");
+}
+
+TEST_CASE("The call graph is stored in compressed sparse row form", "[libclang]")
+{
+  if (skipTest())
+    return;
+
+  write_file("calls.h",
+    "#pragma once\n"
+    "void leaf();\n"
+    "void process(int);\n"
+    "void process(double);\n"
+    "struct Base { virtual void run(); void helper(); };\n"
+    "inline void shared() { leaf(); }\n"
+    "template<class T> void generic(T t) { process(t); }");
+
+  write_file("a.cpp",
+    "#include \"calls.h\"\n"
+    "void Base::run() { helper(); leaf(); }\n"
+    "void mid(Base& b) { b.run(); }\n"
+    "namespace ns { void f(); void f(int); }\n"
+    "void h() { using ns::f; }\n"
+    "template<class A, class F> void apply(A a, F f);\n"
+    "template<class T> T make(T t);\n"
+    "template<class T> void nested(T t) { apply(make(t), process); }");
+
+  write_file("b.cpp",
+    "#include \"calls.h\"\n"
+    "void mid(Base& b);\n"
+    "void top(Base& b) { mid(b); shared(); }");
+
+  libclang::LibClang libclang;
+  libclang::Index index = libclang.createIndex();
+  libclang::TranslationUnit tu_a = index.parseTranslationUnit("a.cpp", {});
+  libclang::TranslationUnit tu_b = index.parseTranslationUnit("b.cpp", {});
+
+  libclang::Cursor tu_root = tu_a.getCursor();
+  libclang::SymbolKey leaf = libclang::symbolKey(tu_root.childAt(0));
+  libclang::SymbolKey process_int = libclang::symbolKey(tu_root.childAt(1));
+  libclang::SymbolKey generic = libclang::symbolKey(tu_root.childAt(5));
+  libclang::SymbolKey run = libclang::symbolKey(tu_root.childAt(6));
+  libclang::SymbolKey mid = libclang::symbolKey(tu_root.childAt(7));
+  libclang::SymbolKey top = libclang::symbolKey(tu_b.getCursor().childAt(7));
+
+  libclang::CallGraph graph{ tu_a };
+  REQUIRE(graph.edgeCount() == 8);
+
+  libclang::CallGraph::NodeId mid_id = graph.find(mid);
+  REQUIRE(graph.callees(mid_id).size() == 1);
+  REQUIRE(graph.key(graph.callees(mid_id).front()) == run);
+  REQUIRE(graph.calleeFlags(mid_id).front() == libclang::CallEdge::DynamicCall);
+
+  libclang::CallGraph::NodeId generic_id = graph.find(generic);
+  REQUIRE(graph.callees(generic_id).size() == 2);
+  REQUIRE(graph.calleeFlags(generic_id).front() == libclang::CallEdge::OverloadedCall);
+  REQUIRE(graph.callers(graph.find(process_int)).size() == 1);
+
+  REQUIRE(graph.find(top) == libclang::CallGraph::NoNode);
+  // a using-declaration names an overload set but calls nothing
+  REQUIRE(graph.find(libclang::symbolKey(tu_root.childAt(9))) == libclang::CallGraph::NoNode);
+
+  // apply(make(t), process): the overload set passed after a nested call is not called
+  libclang::CallGraph::NodeId nested_id = graph.find(libclang::symbolKey(tu_root.childAt(12)));
+  REQUIRE(graph.callees(nested_id).size() == 2);
+  REQUIRE(graph.key(graph.callees(nested_id).front()) != process_int);
+  REQUIRE(graph.key(graph.callees(nested_id).back()) != process_int);
+
+  libclang::ThreadPool pool{ 2 };
+  libclang::CallGraph project = libclang::buildCallGraph(pool, { &tu_a, &tu_b });
+
+  graph.merge(libclang::CallGraph(tu_b));
+  REQUIRE(graph.edgeCount() == 10);
+  REQUIRE(project.edgeCount() == graph.edgeCount());
+  REQUIRE(project.nodeCount() == graph.nodeCount());
+
+  // top -> mid, shared -> run, leaf -> helper, leaf
+  REQUIRE(graph.reachableFrom(graph.find(top)).size() == 5);
+
+  std::vector<libclang::CallGraph::NodeId> impact = project.impactOf(project.find(leaf));
+  REQUIRE(impact.size() == 4);
+  REQUIRE(std::find(impact.begin(), impact.end(), project.find(top)) != impact.end());
+  REQUIRE(std::find(impact.begin(), impact.end(), project.find(generic)) == impact.end());
+}
+
+TEST_CASE("Documentation comments of shared headers are extracted once", "[libclang]")
+{
+  if (skipTest())
+    return;
+
+  write_file("docs.h",
+    "#pragma once\n"
+    "/// Computes the area.\n"
+    "/// Returns a positive value.\n"
+    "double area(double w, double h);\n"
+    "/** \\brief A shape. */\n"
+    "struct Shape { int sides; };");
+
+  write_file("a.cpp",
+    "#include \"docs.h\"\n"
+    "/// Entry point.\n"
+    "int run() { return 0; }");
+
+  write_file("b.cpp",
+    "#include \"docs.h\"");
+
+  libclang::LibClang libclang;
+  libclang::Index index = libclang.createIndex();
+  libclang::TranslationUnit tu_a = index.parseTranslationUnit("a.cpp", {});
+  libclang::TranslationUnit tu_b = index.parseTranslationUnit("b.cpp", {});
+
+  libclang::Cursor area = tu_a.getCursor().childAt(0);
+  REQUIRE(area.getRawCommentText() == "/// Computes the area.\n/// Returns a positive value.");
+  REQUIRE(area.getBriefCommentText() == "Computes the area. Returns a positive value.");
+  REQUIRE(area.getCommentRange().getRangeStart().getSpellingLocation().line == 2);
+  REQUIRE(tu_a.getCursor().childAt(1).childAt(0).getRawCommentText().empty());
+
+  using Table = libclang::DeclarationTable;
+
+  libclang::ThreadPool pool{ 2 };
+  libclang::DocCommentCache cache;
+  Table table = libclang::extractDeclarations(pool, { &tu_a, &tu_b }, Table::Name | Table::RawComment | Table::BriefComment, Table::NoOption, &cache);
+
+  REQUIRE(table.size() == 5 + 1 + 5);
+  REQUIRE(table.name(0) == "area");
+  REQUIRE(table.rawComment(0) == area.getRawCommentText());
+  REQUIRE(table.briefComment(3) == "A shape.");
+  REQUIRE(table.briefComment(4).empty());
+  REQUIRE(table.name(5) == "run");
+  REQUIRE(table.briefComment(5) == "Entry point.");
+  REQUIRE(table.rawComment(6) == table.rawComment(0));
+  REQUIRE(table.briefComment(9) == "A shape.");
+
+  // which unit fills the cache depends on the scheduling, not its content
+  REQUIRE(cache.size() == 6);
+
+  // filled sequentially, the declarations of the header are found by the second unit
+  libclang::DocCommentCache sequential_cache;
+  Table sequential{ Table::Name | Table::RawComment | Table::BriefComment };
+  sequential.extract(tu_a, Table::NoOption, &sequential_cache);
+  REQUIRE(sequential_cache.hits() == 0);
+  sequential.extract(tu_b, Table::NoOption, &sequential_cache);
+  REQUIRE(sequential_cache.size() == 6);
+  REQUIRE(sequential_cache.hits() == 5);
+  REQUIRE(sequential.briefComment(9) == "A shape.");
+
+  Table raw_only{ tu_b, Table::RawComment };
+  REQUIRE(raw_only.brief_comments.empty());
+  REQUIRE(raw_only.rawComment(3) == "/** \\brief A shape. */");
+}
+
+TEST_CASE("Declarations are pretty-printed with a cached policy", "[libclang]")
+{
+  if (skipTest())
+    return;
+
+  write_file("test.cpp",
+    "namespace math { int add(int a, int b) { return a + b; } }\n"
+    "const int answer = 42;");
+
+  libclang::LibClang libclang;
+  libclang::Index index = libclang.createIndex();
+  libclang::TranslationUnit tu = index.parseTranslationUnit("test.cpp", {});
+
+  libclang::Cursor add = tu.getCursor().childAt(0).childAt(0);
+  libclang::Cursor answer = tu.getCursor().childAt(1);
+
+  libclang::DeclarationPrinter printer{ tu };
+  const libclang::PrintingPolicy& policy = printer.policy();
+  REQUIRE(policy.get(CXPrintingPolicy_TerseOutput) == 1);
+
+  REQUIRE(add.prettyPrinted(policy).view() == "int add(int a, int b)");
+  REQUIRE(printer.print(answer).view() == "const int answer = 42");
+
+  libclang::PrintingPolicy full{ add };
+  REQUIRE(!full.isNull());
+  REQUIRE(full.get(CXPrintingPolicy_TerseOutput) == 0);
+  full.set(CXPrintingPolicy_FullyQualifiedName, 1);
+  full.set(CXPrintingPolicy_TerseOutput, 1);
+  REQUIRE(add.prettyPrinted(full).view() == "int math::add(int a, int b)");
+
+  CXPrintingPolicy handle = policy;
+  libclang::DeclarationPrinter moved{ std::move(printer) };
+  REQUIRE(moved.policy().policy == handle);
+  REQUIRE(moved.print(add).view() == "int add(int a, int b)");
+}
+
+TEST_CASE("Constants are evaluated into a table keyed by symbol", "[libclang]")
+{
+  if (skipTest())
+    return;
+
+  write_file("test.cpp",
+    "enum Color { Red, Green = 5, Blue };\n"
+    "enum class Flags : unsigned { All = 0xFFFFFFFF };\n"
+    "constexpr int answer = 6 * 7;\n"
+    "constexpr double half = 0.5;\n"
+    "constexpr const char* greeting = \"hello\";\n"
+    "struct Limits { static const int max = 100; static constexpr unsigned long long big = 1ull << 40; };\n"
+    "int runtime_value();\n"
+    "const int runtime = runtime_value();\n"
+    "int counter = 3;\n"
+    "template<class T> struct Box { static const int size = sizeof(T); };\n"
+    "void f() { const int local = 4; }\n"
+    "typedef unsigned long long u64;\n"
+    "enum E : u64 { Big = 0xFFFFFFFFFFFFFFFFull };");
+
+  libclang::LibClang libclang;
+  libclang::Index index = libclang.createIndex();
+  libclang::TranslationUnit tu = index.parseTranslationUnit("test.cpp", {});
+
+  libclang::Cursor root = tu.getCursor();
+  libclang::Cursor green = root.childAt(0).childAt(1);
+  REQUIRE(green.getEnumConstantDeclValue() == 5);
+  REQUIRE(root.childAt(1).getEnumDeclIntegerType().getSpelling() == "unsigned int");
+
+  libclang::EvalResult eval{ root.childAt(2) };
+  REQUIRE(!eval.isNull());
+  REQUIRE(eval.kind() == CXEval_Int);
+  REQUIRE(eval.asInt() == 42);
+
+  libclang::ConstantTable constants{ tu };
+
+  using Table = libclang::ConstantTable;
+  auto row = [&](const libclang::Cursor& c) { return constants.find(libclang::symbolKey(c)); };
+
+  REQUIRE(constants.toInt(row(root.childAt(0).childAt(0))) == 0);
+  REQUIRE(constants.toInt(row(green)) == 5);
+  REQUIRE(constants.toInt(row(root.childAt(0).childAt(2))) == 6);
+  REQUIRE(constants.types.at(row(root.childAt(1).childAt(0))) == Table::UnsignedInteger);
+  REQUIRE(constants.toUnsigned(row(root.childAt(1).childAt(0))) == 0xFFFFFFFF);
+
+  REQUIRE(constants.kinds.at(row(root.childAt(2))) == CXCursor_VarDecl);
+  REQUIRE(constants.toInt(row(root.childAt(2))) == 42);
+  REQUIRE(constants.types.at(row(root.childAt(3))) == Table::Float);
+  REQUIRE(constants.toDouble(row(root.childAt(3))) == 0.5);
+  REQUIRE(constants.types.at(row(root.childAt(4))) == Table::String);
+  REQUIRE(constants.toString(row(root.childAt(4))) == "hello");
+
+  libclang::Cursor limits = root.childAt(5);
+  REQUIRE(constants.toInt(row(limits.childAt(0))) == 100);
+  REQUIRE(constants.types.at(row(limits.childAt(1))) == Table::UnsignedInteger);
+  REQUIRE(constants.toUnsigned(row(limits.childAt(1))) == (1ull << 40));
+
+  REQUIRE(row(root.childAt(7)) == Table::NoRow);
+  REQUIRE(row(root.childAt(8)) == Table::NoRow);
+
+  libclang::Cursor big = root.childAt(12).childAt(0);
+  REQUIRE(constants.types.at(row(big)) == Table::UnsignedInteger);
+  REQUIRE(constants.toUnsigned(row(big)) == 0xFFFFFFFFFFFFFFFFull);
+
+  REQUIRE(constants.size() == 3 + 1 + 3 + 2 + 1);
+}